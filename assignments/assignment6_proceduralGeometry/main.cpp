@@ -14,6 +14,7 @@
 #include <ew/transform.h>
 #include <ew/camera.h>
 #include <ew/cameraController.h>
+#include <ew/ringBuffer.h>
 #include <patchwork/procGen.h>
 
 void framebufferSizeCallback(GLFWwindow* window, int width, int height);
@@ -33,6 +34,8 @@ struct AppSettings {
 	bool wireframe = true;
 	bool drawAsPoints = false;
 	bool backFaceCulling = true;
+	int sphereSegments = 6;
+	bool animateSphere = false; //Regenerates the sphere with a pulsing radius every frame
 
 	//Euler angles (degrees)
 	ew::Vec3 lightRotation = ew::Vec3(0, 0, 0);
@@ -102,9 +105,11 @@ int main() {
 	ew::Transform cylinderTransform;
 	cylinderTransform.position = ew::Vec3(-5.0f, 0.0f, 0.0f);
 
-	//Create Sphere
-	ew::MeshData sphereMeshData = patchwork::createSphere(5.0f, 6);
-	ew::Mesh sphereMesh(sphereMeshData);
+	//Create Sphere. While animated it is rebuilt every frame, so it streams through a ring buffer instead of reallocating its own.
+	//Otherwise it sits in its own buffers, rebuilt only when the segment count changes
+	ew::RingBuffer streamBuffer(4 * 1024 * 1024);
+	ew::Mesh sphereMesh;
+	int staticSphereSegments = 0; //Segments of the sphere in sphereMesh's own buffers, 0 if there isn't one
 
 	//Initialize transforms
 	ew::Transform sphereTransform;
@@ -122,6 +127,27 @@ int main() {
 
 		cameraController.Move(window, &camera, deltaTime);
 
+		//Animated sphere vertices are written straight into this frame's part of the ring
+		streamBuffer.beginFrame();
+		const int sphereSegments = appSettings.sphereSegments;
+		const ew::MeshCounts sphereCounts = ew::querySphereCounts(sphereSegments);
+		bool sphereStreamed = false;
+		if (appSettings.animateSphere)
+		{
+			const float sphereRadius = 5.0f + sinf(time * 2.0f);
+			sphereStreamed = sphereMesh.loadDynamic(streamBuffer, sphereCounts, [&](ew::Vertex* vertices, unsigned int* indices) {
+				patchwork::createSphere(sphereRadius, sphereSegments, vertices, indices);
+			});
+		}
+		//Still, or too many segments to fit in the ring: the unanimated sphere in the mesh's own buffers, uploaded once
+		if (!sphereStreamed && (sphereMesh.isDynamic() || staticSphereSegments != sphereSegments))
+		{
+			sphereMesh.load(sphereCounts, [&](ew::Vertex* vertices, unsigned int* indices) {
+				patchwork::createSphere(5.0f, sphereSegments, vertices, indices);
+			});
+			staticSphereSegments = sphereSegments;
+		}
+
 		//Render
 		glClearColor(appSettings.bgColor.x, appSettings.bgColor.y, appSettings.bgColor.z,1.0f);
 
@@ -157,6 +183,7 @@ int main() {
 		//Draw Sphere
 		shader.setMat4("_Model", sphereTransform.getModelMatrix());
 		sphereMesh.draw((ew::DrawMode)appSettings.drawAsPoints);
+		streamBuffer.endFrame();
 
 		//Render UI
 		{
@@ -190,6 +217,8 @@ int main() {
 			if (appSettings.shadingModeIndex > 3) {
 				ImGui::DragFloat3("Light Rotation", &appSettings.lightRotation.x, 1.0f);
 			}
+			ImGui::SliderInt("Sphere segments", &appSettings.sphereSegments, 3, 256);
+			ImGui::Checkbox("Animate sphere", &appSettings.animateSphere);
 			ImGui::Checkbox("Draw as points", &appSettings.drawAsPoints);
 			if (ImGui::Checkbox("Wireframe", &appSettings.wireframe)) {
 				glPolygonMode(GL_FRONT_AND_BACK, appSettings.wireframe ? GL_LINE : GL_FILL);
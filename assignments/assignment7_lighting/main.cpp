@@ -86,7 +86,11 @@ int main() {
 	//Create cube
 	ew::Mesh cubeMesh(ew::createCube(1.0f));
 	ew::Mesh planeMesh(ew::createPlane(5.0f, 5.0f, 10));
-	ew::Mesh sphereMesh(ew::createSphere(0.5f, 64));
+	//Generated straight into the mapped GPU buffers, no MeshData copy
+	ew::Mesh sphereMesh;
+	sphereMesh.load(ew::querySphereCounts(64), [](ew::Vertex* vertices, unsigned int* indices) {
+		ew::createSphere(0.5f, 64, vertices, indices);
+	});
 	ew::Mesh cylinderMesh(ew::createCylinder(0.5f, 1.0f, 32));
 	Light lights[3];
 
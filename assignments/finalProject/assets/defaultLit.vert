@@ -12,11 +12,12 @@ out Surface{
 }vs_out;
 
 uniform mat4 _Model;
+uniform mat3 _NormalMatrix; //Inverse transpose of _Model, computed once per object on the CPU
 uniform mat4 _ViewProjection;
 
 void main(){
 	vs_out.UV = vUV;
 	vs_out.WorldPosition = vec3(_Model * vec4(vPos, 1.0));
-	vs_out.WorldNormal =  vec3(_Model * vec4(vNormal, 1.0));
-	gl_Position = _ViewProjection * _Model * vec4(vPos,1.0);
+	vs_out.WorldNormal = _NormalMatrix * vNormal;
+	gl_Position = _ViewProjection * vec4(vs_out.WorldPosition, 1.0);
 }
@@ -0,0 +1,33 @@
+#version 450
+#extension GL_ARB_shader_draw_parameters : require
+//defaultLitIndirect.vert, use with defaultLit.frag and an ew::DrawList
+layout(location = 0) in vec3 vPos;
+layout(location = 1) in vec3 vNormal;
+layout(location = 2) in vec2 vUV;
+
+//This entire block will be passed to our fragment shader.
+out Surface{
+	vec2 UV;
+	vec3 WorldPosition;
+	vec3 WorldNormal;
+}vs_out;
+
+//Matches ew::DrawData
+struct DrawData{
+	mat4 model;
+	mat3 normalMatrix;
+	vec4 color;
+};
+layout(std430, binding = 0) readonly buffer DrawBuffer{
+	DrawData _Draws[];
+};
+
+uniform mat4 _ViewProjection;
+
+void main(){
+	DrawData draw = _Draws[gl_DrawIDARB];
+	vs_out.UV = vUV;
+	vs_out.WorldPosition = vec3(draw.model * vec4(vPos, 1.0));
+	vs_out.WorldNormal = draw.normalMatrix * vNormal;
+	gl_Position = _ViewProjection * vec4(vs_out.WorldPosition, 1.0);
+}
@@ -0,0 +1,27 @@
+#version 450
+//defaultLitInstanced.vert, use with defaultLit.frag
+layout(location = 0) in vec3 vPos;
+layout(location = 1) in vec3 vNormal;
+layout(location = 2) in vec2 vUV;
+//Per instance, see ew::InstanceData
+layout(location = 3) in mat4 iModel;
+layout(location = 7) in mat3 iNormalMatrix;
+layout(location = 10) in vec4 iColor;
+
+//This entire block will be passed to our fragment shader.
+out Surface{
+	vec2 UV;
+	vec3 WorldPosition;
+	vec3 WorldNormal;
+}vs_out;
+
+uniform mat4 _Model; //Applied before the instance transform, e.g. a mesh's node transform
+uniform mat3 _NormalMatrix; //Inverse transpose of _Model
+uniform mat4 _ViewProjection;
+
+void main(){
+	vs_out.UV = vUV;
+	vs_out.WorldPosition = vec3(iModel * _Model * vec4(vPos, 1.0));
+	vs_out.WorldNormal = iNormalMatrix * _NormalMatrix * vNormal;
+	gl_Position = _ViewProjection * vec4(vs_out.WorldPosition, 1.0);
+}
@@ -0,0 +1,9 @@
+//unlitInstanced.frag
+#version 450
+out vec4 FragColor;
+
+in vec4 Color;
+
+void main(){
+	FragColor = Color;
+}
@@ -0,0 +1,19 @@
+//unlitInstanced.vert
+#version 450
+layout(location = 0) in vec3 vPos;
+layout(location = 1) in vec3 vNormal;
+layout(location = 2) in vec2 vUV;
+//Per instance, see ew::InstanceData
+layout(location = 3) in mat4 iModel;
+layout(location = 7) in mat3 iNormalMatrix;
+layout(location = 10) in vec4 iColor;
+
+out vec4 Color;
+
+uniform mat4 _Model; //Applied before the instance transform, e.g. a mesh's node transform
+uniform mat4 _ViewProjection;
+
+void main(){
+	Color = iColor;
+	gl_Position = _ViewProjection * iModel * _Model * vec4(vPos,1.0);
+}
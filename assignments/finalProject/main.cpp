@@ -10,11 +10,15 @@
 
 #include <ew/shader.h>
 #include <ew/texture.h>
+#include <ew/textureCache.h>
+#include <ew/textureStreamer.h>
 #include <ew/procGen.h>
 #include <ew/transform.h>
+#include <ew/transformHierarchy.h>
 #include <ew/camera.h>
 #include <ew/cameraController.h>
 #include <patchwork/model.h>
+#include <patchwork/modelLoader.h>
 
 void framebufferSizeCallback(GLFWwindow* window, int width, int height);
 void resetCamera(ew::Camera& camera, ew::CameraController& cameraController);
@@ -59,10 +63,18 @@ int main() {
 	glCullFace(GL_BACK);
 	glEnable(GL_DEPTH_TEST);
 
-	patchwork::Model torus("assets/torus.dae"); //WE GOT THE FILES WOO
-	patchwork::Model chandelier("assets/GrappleYChandelier.dae");
-	patchwork::Model flower("assets/Flowa.dae");
-	patchwork::Model plate("assets/plate.dae");
+	//Cooked from the .dae files at build time by ewcook, so loading is a file map and an upload.
+	//The loader maps them all at once on worker threads, only the uploads happen here
+	patchwork::ModelLoader modelLoader;
+	modelLoader.add("assets/torus.ewmodel"); //WE GOT THE FILES WOO
+	modelLoader.add("assets/GrappleYChandelier.ewmodel");
+	modelLoader.add("assets/Flowa.ewmodel");
+	modelLoader.add("assets/Plate.ewmodel");
+	std::vector<patchwork::Model> loadedModels = modelLoader.loadAll();
+	patchwork::Model& torus = loadedModels[0];
+	patchwork::Model& chandelier = loadedModels[1];
+	patchwork::Model& flower = loadedModels[2];
+	patchwork::Model& plate = loadedModels[3];
 
 	struct Light {
 		ew::Vec3 position; //World space
@@ -78,9 +90,11 @@ int main() {
 
 	bool blinn = true;
 
-	ew::Shader shader("assets/defaultLit.vert", "assets/defaultLit.frag");
-	ew::Shader unlit("assets/unlit.vert", "assets/unlit.frag");
-	unsigned int brickTexture = ew::loadTexture("assets/brick_color.jpg", GL_REPEAT, GL_LINEAR);
+	ew::Shader shader("assets/defaultLitIndirect.vert", "assets/defaultLit.frag");
+	//Meshes with their own material textures can't share the multi draw, they go through this one call at a time
+	ew::Shader texturedShader("assets/defaultLit.vert", "assets/defaultLit.frag");
+	ew::Shader unlit("assets/unlitInstanced.vert", "assets/unlitInstanced.frag");
+	unsigned int brickTexture = ew::loadTextureAsync("assets/brick_color.jpg", GL_REPEAT, GL_LINEAR);
 
 	Material material1;
 	material1.ambientK = 0.1f;
@@ -122,6 +136,38 @@ int main() {
 	lights[2].color = ew::Vec3(0, 1, 1);
 	lightTrans[2].position = lights[2].position;
 
+	//One instance per light, drawn with a single call
+	ew::Mesh lightMesh(ew::createCube(0.5f));
+	ew::InstanceData lightInstances[3];
+	for (int i = 0; i < 3; i++)
+	{
+		lightInstances[i] = ew::InstanceData(lightTrans[i].getModelMatrix(), ew::Vec4(lights[i].color.x, lights[i].color.y, lights[i].color.z, 1.0f));
+	}
+	ew::InstanceBuffer lightInstanceBuffer;
+	lightInstanceBuffer.upload(lightInstances, 3);
+	lightMesh.setInstanceBuffer(lightInstanceBuffer);
+
+	//Scene models and their transforms, in the same order
+	const int NUM_MODELS = 4;
+	patchwork::Model* models[NUM_MODELS] = { &torus, &chandelier, &flower, &plate };
+	ew::Transform* modelTransforms[NUM_MODELS] = { &torusTransform, &chandTransform, &flowerTransform, &plateTransform };
+	//Node i is models[i]. Nothing moves, so world matrices and bounds are only computed once
+	ew::TransformHierarchy sceneNodes;
+	sceneNodes.reserve(NUM_MODELS);
+	for (int i = 0; i < NUM_MODELS; i++)
+	{
+		sceneNodes.add(*modelTransforms[i]);
+	}
+	//Every model shares one vertex and index buffer, and the visible ones are drawn in a single multi draw
+	ew::GeometryArena sceneGeometry;
+	for (int i = 0; i < NUM_MODELS; i++)
+	{
+		models[i]->AddToArena(sceneGeometry);
+	}
+	ew::DrawList sceneDraws(sceneGeometry);
+	ew::AABB worldBounds[NUM_MODELS];
+	std::vector<unsigned int> visibleModels;
+
 	resetCamera(camera, cameraController);
 
 	while (!glfwWindowShouldClose(window)) {
@@ -131,6 +177,9 @@ int main() {
 		float deltaTime = time - prevTime;
 		prevTime = time;
 
+		//Swap in textures decoded since last frame, a couple of milliseconds' worth at most
+		ew::TextureStreamer::global().update(2.0f);
+
 		//Update camera
 		camera.aspectRatio = (float)SCREEN_WIDTH / SCREEN_HEIGHT;
 		cameraController.Move(window, &camera, deltaTime);
@@ -139,50 +188,62 @@ int main() {
 		glClearColor(bgColor.x, bgColor.y, bgColor.z, 1.0f);
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-		shader.use();
-		glBindTexture(GL_TEXTURE_2D, brickTexture);
-		shader.setInt("_Texture", 0);
-		shader.setMat4("_ViewProjection", camera.ProjectionMatrix() * camera.ViewMatrix());
-		shader.setVec3("_ViewLocation", camera.position);
+		//Both lit shaders take the same camera, lights and material
+		auto setLighting = [&](ew::Shader& litShader) {
+			litShader.use();
+			litShader.setInt("_Texture", 0);
+			litShader.setMat4("_ViewProjection", camera.ProjectionMatrix() * camera.ViewMatrix());
+			litShader.setVec3("_ViewLocation", camera.position);
+			litShader.setVec3("_Lights[0].position", lights[0].position);
+			litShader.setVec3("_Lights[0].color", lights[0].color);
+			litShader.setVec3("_Lights[1].position", lights[1].position);
+			litShader.setVec3("_Lights[1].color", lights[1].color);
+			litShader.setVec3("_Lights[2].position", lights[2].position);
+			litShader.setVec3("_Lights[2].color", lights[2].color);
+			litShader.setFloat("_Material.ambientK", material1.ambientK);
+			litShader.setFloat("_Material.diffuseK", material1.diffuseK);
+			litShader.setFloat("_Material.shininess", material1.shininess);
+			litShader.setFloat("_Material.specular", material1.specular);
+			if (blinn)
+				litShader.setInt("blinn", 1);
+			else
+				litShader.setInt("blinn", 0);
+		};
 
 		ew::Mat4 model = ew::Mat4(1.0f);
 
-		shader.setMat4("_Model", torusTransform.getModelMatrix()); //PUT THAT DONUT IN THE MFIN SCENE 
-		torus.Draw(shader);
-
-		shader.setMat4("_Model", chandTransform.getModelMatrix());
-		chandelier.Draw(shader);
-
-		shader.setMat4("_Model", flowerTransform.getModelMatrix());
-		flower.Draw(shader);
-
-		shader.setMat4("_Model", plateTransform.getModelMatrix());
-		plate.Draw(shader);
-
-		shader.setVec3("_Lights[0].position", lights[0].position);
-		shader.setVec3("_Lights[0].color", lights[0].color);
-		shader.setVec3("_Lights[1].position", lights[1].position);
-		shader.setVec3("_Lights[1].color", lights[1].color);
-		shader.setVec3("_Lights[2].position", lights[2].position);
-		shader.setVec3("_Lights[2].color", lights[2].color);
-		shader.setFloat("_Material.ambientK", material1.ambientK);
-		shader.setFloat("_Material.diffuseK", material1.diffuseK);
-		shader.setFloat("_Material.shininess", material1.shininess);
-		shader.setFloat("_Material.specular", material1.specular);
-		if (blinn)
-			shader.setInt("blinn", 1);
-		else
-			shader.setInt("blinn", 0);
-
-		//TODO: Render point lights
-		unlit.use();
-		unlit.setMat4("_ViewProjection", camera.ProjectionMatrix() * camera.ViewMatrix());
-		for (int i = 0; i < 3; i++)
+		//Only draw models whose world bounds touch the view frustum
+		if (sceneNodes.update() > 0)
+		{
+			for (int i = 0; i < NUM_MODELS; i++)
+			{
+				worldBounds[i] = ew::TransformAABB(models[i]->getBounds(), sceneNodes.getWorld(i));
+			}
+		}
+		ew::CullAABBs(camera.ViewFrustum(), worldBounds, NUM_MODELS, visibleModels);
+		sceneDraws.clear();
+		for (unsigned int i : visibleModels)
+		{
+			models[i]->AddDraws(sceneDraws, sceneNodes.getWorld(i), camera, (float)SCREEN_HEIGHT);
+		}
+
+		//Untextured meshes wear the brick
+		setLighting(shader);
+		glBindTexture(GL_TEXTURE_2D, brickTexture);
+		sceneDraws.draw();
+
+		setLighting(texturedShader);
+		for (unsigned int i : visibleModels)
 		{
-			unlit.setMat4("_Model", lightTrans[i].getModelMatrix());
-			unlit.setVec3("_Color", lights[i].color);
+			models[i]->DrawTextured(texturedShader, sceneNodes.getWorld(i), camera, (float)SCREEN_HEIGHT);
 		}
 
+		//Render point lights
+		unlit.use();
+		unlit.setMat4("_ViewProjection", camera.ProjectionMatrix() * camera.ViewMatrix());
+		unlit.setMat4("_Model", ew::IdentityMatrix());
+		lightMesh.drawInstanced((int)lightInstanceBuffer.getCount());
+
 
 		//Render UI
 		{
@@ -212,6 +273,12 @@ int main() {
 			}
 
 			ImGui::ColorEdit3("BG color", &bgColor.x);
+			if (ImGui::CollapsingHeader("Textures")) {
+				const ew::TextureCacheStats& textureStats = ew::TextureCache::global().getStats();
+				ImGui::Text("Resident: %zu (%.1f MB)", textureStats.textures, textureStats.bytesResident / (1024.0f * 1024.0f));
+				ImGui::Text("Hits: %zu by path, %zu by content", textureStats.hits, textureStats.contentHits);
+				ImGui::Text("Misses: %zu, failed: %zu, loading: %zu", textureStats.misses, textureStats.failures, textureStats.pending);
+			}
 			ImGui::End();
 
 			ImGui::Render();
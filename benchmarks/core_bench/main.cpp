@@ -0,0 +1,6 @@
+//core_bench
+//Run with --benchmark_out=results.json --benchmark_out_format=json to save results,
+//or build the runCoreBench target.
+#include <benchmark/benchmark.h>
+
+BENCHMARK_MAIN();
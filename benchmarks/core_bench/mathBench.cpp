@@ -0,0 +1,204 @@
+//ewMath and patchwork transformation benchmarks
+#include <vector>
+#include <benchmark/benchmark.h>
+
+#include <ew/ewMath/ewMath.h>
+#include <ew/ewMath/transformations.h>
+#include <ew/transform.h>
+#include <ew/transformBatch.h>
+#include <patchwork/transformations.h>
+
+//Inputs are read from arrays so the compiler can't fold the math away
+static const int NUM_INPUTS = 1024;
+
+static std::vector<ew::Vec3> makeVec3s() {
+	std::vector<ew::Vec3> v(NUM_INPUTS);
+	for (int i = 0; i < NUM_INPUTS; i++)
+		v[i] = ew::Vec3(ew::RandomRange(-10, 10), ew::RandomRange(-10, 10), ew::RandomRange(-10, 10));
+	return v;
+}
+
+static std::vector<ew::Transform> makeTransforms() {
+	std::vector<ew::Transform> t(NUM_INPUTS);
+	for (int i = 0; i < NUM_INPUTS; i++) {
+		t[i].position = ew::Vec3(ew::RandomRange(-10, 10), ew::RandomRange(-10, 10), ew::RandomRange(-10, 10));
+		t[i].rotation = ew::Vec3(ew::RandomRange(-180, 180), ew::RandomRange(-180, 180), ew::RandomRange(-180, 180));
+		t[i].scale = ew::Vec3(ew::RandomRange(0.1f, 2), ew::RandomRange(0.1f, 2), ew::RandomRange(0.1f, 2));
+	}
+	return t;
+}
+
+static std::vector<patchwork::Transform> toPatchwork(const std::vector<ew::Transform>& in) {
+	std::vector<patchwork::Transform> out(in.size());
+	for (size_t i = 0; i < in.size(); i++) {
+		out[i].position = in[i].position;
+		out[i].rotation = in[i].rotation;
+		out[i].scale = in[i].scale;
+	}
+	return out;
+}
+
+//Vec3/Vec4
+static void BM_Vec3_AddScale(benchmark::State& state) {
+	auto a = makeVec3s(), b = makeVec3s();
+	int i = 0;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize((a[i] + b[i]) * 0.5f);
+		i = (i + 1) % NUM_INPUTS;
+	}
+}
+BENCHMARK(BM_Vec3_AddScale);
+
+static void BM_Vec3_Cross(benchmark::State& state) {
+	auto a = makeVec3s(), b = makeVec3s();
+	int i = 0;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(ew::Cross(a[i], b[i]));
+		i = (i + 1) % NUM_INPUTS;
+	}
+}
+BENCHMARK(BM_Vec3_Cross);
+
+static void BM_Vec3_Normalize(benchmark::State& state) {
+	auto a = makeVec3s();
+	int i = 0;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(ew::Normalize(a[i]));
+		i = (i + 1) % NUM_INPUTS;
+	}
+}
+BENCHMARK(BM_Vec3_Normalize);
+
+static void BM_Vec4_DotNormalize(benchmark::State& state) {
+	auto a = makeVec3s(), b = makeVec3s();
+	int i = 0;
+	for (auto _ : state) {
+		ew::Vec4 v = ew::Normalize(ew::Vec4(a[i], 1.0f));
+		benchmark::DoNotOptimize(ew::Dot(v, ew::Vec4(b[i], 0.0f)));
+		i = (i + 1) % NUM_INPUTS;
+	}
+}
+BENCHMARK(BM_Vec4_DotNormalize);
+
+//Mat4
+static void BM_Mat4_MulMat4(benchmark::State& state) {
+	auto t = makeTransforms();
+	std::vector<ew::Mat4> m(NUM_INPUTS);
+	for (int i = 0; i < NUM_INPUTS; i++)
+		m[i] = t[i].getModelMatrix();
+	int i = 0;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(m[i] * m[(i + 1) % NUM_INPUTS]);
+		i = (i + 1) % NUM_INPUTS;
+	}
+}
+BENCHMARK(BM_Mat4_MulMat4);
+
+static void BM_Mat4_MulVec4(benchmark::State& state) {
+	auto t = makeTransforms();
+	auto v = makeVec3s();
+	std::vector<ew::Mat4> m(NUM_INPUTS);
+	for (int i = 0; i < NUM_INPUTS; i++)
+		m[i] = t[i].getModelMatrix();
+	int i = 0;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(m[i] * ew::Vec4(v[i], 1.0f));
+		i = (i + 1) % NUM_INPUTS;
+	}
+}
+BENCHMARK(BM_Mat4_MulVec4);
+
+//ew vs patchwork builders
+static void BM_ew_LookAt(benchmark::State& state) {
+	auto eye = makeVec3s(), target = makeVec3s();
+	int i = 0;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(ew::LookAt(eye[i], target[i], ew::Vec3(0, 1, 0)));
+		i = (i + 1) % NUM_INPUTS;
+	}
+}
+BENCHMARK(BM_ew_LookAt);
+
+static void BM_patchwork_LookAt(benchmark::State& state) {
+	auto eye = makeVec3s(), target = makeVec3s();
+	int i = 0;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(patchwork::LookAt(eye[i], target[i], ew::Vec3(0, 1, 0)));
+		i = (i + 1) % NUM_INPUTS;
+	}
+}
+BENCHMARK(BM_patchwork_LookAt);
+
+static void BM_ew_Perspective(benchmark::State& state) {
+	auto v = makeVec3s();
+	int i = 0;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(ew::Perspective(ew::Radians(60.0f + v[i].x), 1.77f, 0.1f, 100.0f));
+		i = (i + 1) % NUM_INPUTS;
+	}
+}
+BENCHMARK(BM_ew_Perspective);
+
+static void BM_patchwork_Perspective(benchmark::State& state) {
+	auto v = makeVec3s();
+	int i = 0;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(patchwork::Perspective(ew::Radians(60.0f + v[i].x), 1.77f, 0.1f, 100.0f));
+		i = (i + 1) % NUM_INPUTS;
+	}
+}
+BENCHMARK(BM_patchwork_Perspective);
+
+static void BM_ew_Transform_getModelMatrix(benchmark::State& state) {
+	auto t = makeTransforms();
+	int i = 0;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(t[i].getModelMatrix());
+		i = (i + 1) % NUM_INPUTS;
+	}
+}
+BENCHMARK(BM_ew_Transform_getModelMatrix);
+
+static void BM_patchwork_Transform_getModelMatrix(benchmark::State& state) {
+	auto t = toPatchwork(makeTransforms());
+	int i = 0;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(t[i].getModelMatrix());
+		i = (i + 1) % NUM_INPUTS;
+	}
+}
+BENCHMARK(BM_patchwork_Transform_getModelMatrix);
+
+//Whole scene of model matrices per iteration
+static void BM_ew_Transform_getModelMatrix_Loop(benchmark::State& state) {
+	std::vector<ew::Transform> t;
+	while (t.size() < (size_t)state.range(0)) {
+		auto more = makeTransforms();
+		t.insert(t.end(), more.begin(), more.end());
+	}
+	t.resize(state.range(0));
+	std::vector<ew::Mat4> out(t.size());
+	for (auto _ : state) {
+		for (size_t i = 0; i < t.size(); i++)
+			out[i] = t[i].getModelMatrix();
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ew_Transform_getModelMatrix_Loop)->Arg(1024)->Arg(65536);
+
+static void BM_TransformBatch_computeModelMatrices(benchmark::State& state) {
+	ew::TransformBatch batch;
+	while (batch.size() < (size_t)state.range(0)) {
+		for (const ew::Transform& t : makeTransforms())
+			batch.push_back(t);
+	}
+	batch.resize(state.range(0));
+	std::vector<ew::Mat4> out(batch.size());
+	for (auto _ : state) {
+		batch.computeModelMatrices(out.data());
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_TransformBatch_computeModelMatrices)->Arg(1024)->Arg(65536);
@@ -0,0 +1,42 @@
+//Mesh optimizer throughput. Triangles are shuffled first so there is something to fix, ACMR/ATVR are reported as counters
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <benchmark/benchmark.h>
+
+#include <ew/procGen.h>
+#include <ew/meshOptimizer.h>
+
+static ew::MeshData shuffledSphere(int subdivisions) {
+	ew::MeshData mesh = ew::createSphere(1.0f, subdivisions);
+	std::vector<size_t> order(mesh.indices.size() / 3);
+	for (size_t i = 0; i < order.size(); i++)
+		order[i] = i;
+	std::shuffle(order.begin(), order.end(), std::mt19937(1));
+	std::vector<unsigned int> indices;
+	indices.reserve(mesh.indices.size());
+	for (size_t triangle : order)
+		indices.insert(indices.end(), mesh.indices.begin() + triangle * 3, mesh.indices.begin() + triangle * 3 + 3);
+	mesh.indices = indices;
+	return mesh;
+}
+
+static void BM_OptimizeMesh(benchmark::State& state) {
+	const ew::MeshData source = shuffledSphere((int)state.range(0));
+	ew::MeshOptimizeOptions options;
+	options.overdraw = state.range(1) != 0;
+	ew::MeshOptimizeStats stats = {};
+	for (auto _ : state) {
+		state.PauseTiming();
+		ew::MeshData mesh = source;
+		state.ResumeTiming();
+		stats = ew::OptimizeMesh(mesh, options);
+		benchmark::DoNotOptimize(mesh.indices.data());
+	}
+	state.counters["acmrBefore"] = stats.before.acmr;
+	state.counters["acmrAfter"] = stats.after.acmr;
+	state.counters["atvrBefore"] = stats.before.atvr;
+	state.counters["atvrAfter"] = stats.after.atvr;
+	state.counters["triangles/s"] = benchmark::Counter((double)(source.indices.size() / 3) * state.iterations(), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_OptimizeMesh)->ArgNames({ "subdivisions", "overdraw" })->Args({ 64, 0 })->Args({ 64, 1 })->Args({ 512, 0 })->Args({ 512, 1 })->Unit(benchmark::kMillisecond);
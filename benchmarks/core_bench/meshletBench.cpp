@@ -0,0 +1,39 @@
+//Meshlet building and per frame cluster culling. The fraction of triangles culling keeps is reported as a counter
+#include <vector>
+#include <benchmark/benchmark.h>
+
+#include <ew/procGen.h>
+#include <ew/meshOptimizer.h>
+#include <ew/meshlet.h>
+
+static void BM_BuildMeshlets(benchmark::State& state) {
+	ew::MeshData source = ew::createSphere(1.0f, (int)state.range(0));
+	ew::OptimizeMesh(source);
+	std::vector<ew::Meshlet> meshlets;
+	for (auto _ : state) {
+		ew::MeshData mesh = source;
+		meshlets = ew::BuildMeshlets(mesh);
+		benchmark::DoNotOptimize(meshlets.data());
+	}
+	state.counters["meshlets"] = (double)meshlets.size();
+	state.counters["triangles/s"] = benchmark::Counter((double)(source.indices.size() / 3) * state.iterations(), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_BuildMeshlets)->ArgName("subdivisions")->Arg(64)->Arg(256)->Arg(1024)->Unit(benchmark::kMillisecond);
+
+static void BM_CullMeshlets(benchmark::State& state) {
+	ew::MeshData mesh = ew::createSphere(1.0f, (int)state.range(0));
+	ew::OptimizeMesh(mesh);
+	const std::vector<ew::Meshlet> meshlets = ew::BuildMeshlets(mesh);
+	ew::Camera camera;
+	camera.position = ew::Vec3(0.0f, 1.0f, 3.0f);
+	const ew::Mat4 model = ew::IdentityMatrix();
+	std::vector<unsigned int> visibleIndices;
+	for (auto _ : state) {
+		visibleIndices.clear();
+		ew::CullMeshlets(ew::MakeMeshletView(camera, model), meshlets.data(), meshlets.size(), mesh.indices.data(), visibleIndices);
+		benchmark::DoNotOptimize(visibleIndices.data());
+	}
+	state.counters["keptTriangles"] = (double)visibleIndices.size() / mesh.indices.size();
+	state.counters["meshlets/s"] = benchmark::Counter((double)meshlets.size() * state.iterations(), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_CullMeshlets)->ArgName("subdivisions")->Arg(64)->Arg(256)->Arg(1024)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,35 @@
+//Vertex packing throughput. The round trip error of each mesh is reported as counters, tests/core_tests/vertexPackingTest enforces the bounds
+#include <vector>
+#include <benchmark/benchmark.h>
+
+#include <ew/procGen.h>
+#include <ew/vertexPacking.h>
+
+static void packMesh(benchmark::State& state, const ew::MeshData& mesh) {
+	std::vector<ew::PackedVertex> packed(mesh.vertices.size());
+	const ew::PackingBounds bounds = ew::ComputePackingBounds(mesh.vertices.data(), mesh.vertices.size());
+	for (auto _ : state) {
+		ew::PackVertices(mesh.vertices.data(), mesh.vertices.size(), bounds, packed.data());
+		benchmark::DoNotOptimize(packed.data());
+	}
+	const ew::PackingError error = ew::MeasurePackingError(mesh.vertices.data(), mesh.vertices.size());
+	state.counters["maxPosError"] = error.position;
+	state.counters["maxNormalErrorDeg"] = error.normalDegrees;
+	state.counters["maxUVError"] = error.uv;
+	state.counters["vertices/s"] = benchmark::Counter((double)mesh.vertices.size() * state.iterations(), benchmark::Counter::kIsRate);
+}
+
+static void BM_PackSphere(benchmark::State& state) {
+	packMesh(state, ew::createSphere(10.0f, (int)state.range(0)));
+}
+BENCHMARK(BM_PackSphere)->Arg(64)->Arg(512);
+
+static void BM_PackPlane(benchmark::State& state) {
+	packMesh(state, ew::createPlane(100.0f, 100.0f, (int)state.range(0)));
+}
+BENCHMARK(BM_PackPlane)->Arg(64)->Arg(512);
+
+static void BM_PackCylinder(benchmark::State& state) {
+	packMesh(state, ew::createCylinder(1.0f, 20.0f, (int)state.range(0)));
+}
+BENCHMARK(BM_PackCylinder)->Arg(64)->Arg(512);
@@ -0,0 +1,75 @@
+//Procedural mesh generation benchmarks. Args are {subdivisions, threads}
+#include <benchmark/benchmark.h>
+
+#include <ew/procGen.h>
+#include <ew/threadPool.h>
+#include <patchwork/procGen.h>
+
+static void procGenArgs(benchmark::internal::Benchmark* b) {
+	for (int subdivisions : { 64, 512, 2048, 4096 })
+		for (int threads : { 1, 2, 4, 8 })
+			b->Args({ subdivisions, threads });
+	b->ArgNames({ "subdivisions", "threads" });
+	b->Unit(benchmark::kMillisecond);
+	b->UseRealTime();
+}
+
+static void setCounters(benchmark::State& state, const ew::MeshData& mesh) {
+	state.counters["vertices"] = (double)mesh.vertices.size();
+	state.counters["vertices/s"] = benchmark::Counter((double)mesh.vertices.size() * state.iterations(), benchmark::Counter::kIsRate);
+}
+
+static void BM_ew_CreatePlane(benchmark::State& state) {
+	ew::ThreadPool pool((unsigned int)state.range(1));
+	ew::MeshData mesh;
+	for (auto _ : state) {
+		mesh = ew::createPlane(10, 10, (int)state.range(0), &pool);
+		benchmark::DoNotOptimize(mesh.vertices.data());
+	}
+	setCounters(state, mesh);
+}
+BENCHMARK(BM_ew_CreatePlane)->Apply(procGenArgs);
+
+static void BM_ew_CreateSphere(benchmark::State& state) {
+	ew::ThreadPool pool((unsigned int)state.range(1));
+	ew::MeshData mesh;
+	for (auto _ : state) {
+		mesh = ew::createSphere(1, (int)state.range(0), &pool);
+		benchmark::DoNotOptimize(mesh.vertices.data());
+	}
+	setCounters(state, mesh);
+}
+BENCHMARK(BM_ew_CreateSphere)->Apply(procGenArgs);
+
+static void BM_ew_CreateCylinder(benchmark::State& state) {
+	ew::ThreadPool pool((unsigned int)state.range(1));
+	ew::MeshData mesh;
+	for (auto _ : state) {
+		mesh = ew::createCylinder(1, 2, (int)state.range(0), &pool);
+		benchmark::DoNotOptimize(mesh.vertices.data());
+	}
+	setCounters(state, mesh);
+}
+BENCHMARK(BM_ew_CreateCylinder)->Apply(procGenArgs);
+
+static void BM_patchwork_CreatePlane(benchmark::State& state) {
+	ew::ThreadPool pool((unsigned int)state.range(1));
+	ew::MeshData mesh;
+	for (auto _ : state) {
+		mesh = patchwork::createPlane(10, 10, (int)state.range(0), &pool);
+		benchmark::DoNotOptimize(mesh.vertices.data());
+	}
+	setCounters(state, mesh);
+}
+BENCHMARK(BM_patchwork_CreatePlane)->Apply(procGenArgs);
+
+static void BM_patchwork_CreateSphere(benchmark::State& state) {
+	ew::ThreadPool pool((unsigned int)state.range(1));
+	ew::MeshData mesh;
+	for (auto _ : state) {
+		mesh = patchwork::createSphere(1, (int)state.range(0), &pool);
+		benchmark::DoNotOptimize(mesh.vertices.data());
+	}
+	setCounters(state, mesh);
+}
+BENCHMARK(BM_patchwork_CreateSphere)->Apply(procGenArgs);
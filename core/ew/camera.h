@@ -1,6 +1,7 @@
 #pragma once
 #include "ewMath/transformations.h"
 #include "ewMath/ewMath.h"
+#include "frustum.h"
 namespace ew {
 
 	struct Camera {
@@ -26,6 +27,10 @@ namespace ew {
 				return ew::Perspective(ew::Radians(fov), aspectRatio, nearPlane, farPlane);
 			}
 		}
+		//World space frustum planes, for culling
+		inline ew::Frustum ViewFrustum()const {
+			return ew::ExtractFrustum(ProjectionMatrix() * ViewMatrix());
+		}
 	};
 
 }
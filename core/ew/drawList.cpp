@@ -0,0 +1,76 @@
+#include "drawList.h"
+#include "external/glad.h"
+
+namespace ew {
+	DrawList::DrawList(const GeometryArena& arena)
+		:m_arena(arena)
+	{
+		glGenBuffers(1, &m_commandBuffer);
+		glGenBuffers(1, &m_drawDataBuffer);
+	}
+
+	DrawList::~DrawList()
+	{
+		glDeleteBuffers(1, &m_commandBuffer);
+		glDeleteBuffers(1, &m_drawDataBuffer);
+	}
+
+	void DrawList::clear()
+	{
+		m_commands.clear();
+		m_drawData.clear();
+	}
+
+	void DrawList::add(int mesh, const ew::Mat4& model, const ew::Vec4& color)
+	{
+		add(mesh, 0, m_arena.get(mesh).indexCount, model, color);
+	}
+
+	void DrawList::add(int mesh, size_t firstIndex, size_t indexCount, const ew::Mat4& model, const ew::Vec4& color)
+	{
+		const ArenaRange& range = m_arena.get(mesh);
+		DrawElementsIndirectCommand command;
+		command.count = (uint32_t)indexCount;
+		command.instanceCount = 1;
+		command.firstIndex = (uint32_t)(range.firstIndex + firstIndex);
+		command.baseVertex = (int32_t)range.firstVertex;
+		command.baseInstance = 0;
+		m_commands.push_back(command);
+
+		DrawData data;
+		data.model = model * range.dequantize;
+		const ew::Mat3 normal = ew::NormalMatrix(model);
+		for (int i = 0; i < 3; i++)
+			data.normal[i] = ew::Vec4(normal.get(i, 0), normal.get(i, 1), normal.get(i, 2), 0.0f);
+		data.color = color;
+		m_drawData.push_back(data);
+	}
+
+	void DrawList::draw()
+	{
+		if (m_commands.empty())
+			return;
+		const size_t count = m_commands.size();
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commandBuffer);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_drawDataBuffer);
+		//Same reuse and orphaning as InstanceBuffer::upload
+		if (count > m_capacity) {
+			m_capacity = count;
+			glBufferData(GL_DRAW_INDIRECT_BUFFER, sizeof(DrawElementsIndirectCommand) * count, m_commands.data(), GL_DYNAMIC_DRAW);
+			glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(DrawData) * count, m_drawData.data(), GL_DYNAMIC_DRAW);
+		}
+		else {
+			glBufferData(GL_DRAW_INDIRECT_BUFFER, sizeof(DrawElementsIndirectCommand) * m_capacity, NULL, GL_DYNAMIC_DRAW);
+			glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, sizeof(DrawElementsIndirectCommand) * count, m_commands.data());
+			glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(DrawData) * m_capacity, NULL, GL_DYNAMIC_DRAW);
+			glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(DrawData) * count, m_drawData.data());
+		}
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, DRAW_DATA_BINDING, m_drawDataBuffer);
+
+		m_arena.bind();
+		glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (const void*)0, (GLsizei)count, 0);
+		glBindVertexArray(0);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+	}
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <vector>
+#include <stdint.h>
+#include "geometryArena.h"
+
+namespace ew {
+	//Per draw data, read by shaders as _Draws[gl_DrawIDARB] from the std430 buffer at DRAW_DATA_BINDING
+	struct DrawData {
+		ew::Mat4 model; //Includes the arena mesh's dequantize matrix
+		ew::Vec4 normal[3]; //Normal matrix columns, padded like a std430 mat3
+		ew::Vec4 color;
+	};
+
+	const unsigned int DRAW_DATA_BINDING = 0;
+
+	//Layout glMultiDrawElementsIndirect reads
+	struct DrawElementsIndirectCommand {
+		uint32_t count;
+		uint32_t instanceCount;
+		uint32_t firstIndex;
+		int32_t baseVertex;
+		uint32_t baseInstance;
+	};
+
+	/// <summary>
+	/// Draws collected from one GeometryArena, submitted with a single glMultiDrawElementsIndirect.
+	/// Shaders need GL_ARB_shader_draw_parameters (core in 4.6) for gl_DrawIDARB.
+	/// Textures and other uniforms are shared by the whole list.
+	/// </summary>
+	class DrawList {
+	public:
+		DrawList(const GeometryArena& arena);
+		~DrawList();
+		DrawList(const DrawList&) = delete;
+		DrawList& operator=(const DrawList&) = delete;
+		void clear();
+		//Draws the whole mesh
+		void add(int mesh, const ew::Mat4& model, const ew::Vec4& color = ew::Vec4(1.0f));
+		//Draws indexCount of the mesh's indices from firstIndex, e.g. one LodLevel
+		void add(int mesh, size_t firstIndex, size_t indexCount, const ew::Mat4& model, const ew::Vec4& color = ew::Vec4(1.0f));
+		//Uploads the commands and draw data, then issues every draw in one call
+		void draw();
+		inline size_t size()const { return m_commands.size(); }
+	private:
+		const GeometryArena& m_arena;
+		std::vector<DrawElementsIndirectCommand> m_commands;
+		std::vector<DrawData> m_drawData;
+		unsigned int m_commandBuffer = 0;
+		unsigned int m_drawDataBuffer = 0;
+		size_t m_capacity = 0; //Draws the GPU buffers can hold
+	};
+}
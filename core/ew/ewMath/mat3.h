@@ -0,0 +1,93 @@
+#pragma once
+#include <cstddef>
+#include "vec3.h"
+#include "mat4.h"
+
+namespace ew {
+	//Column major 3x3, matches GLSL mat3 / glUniformMatrix3fv layout
+	struct Mat3 {
+	private:
+		float n[3][3];
+	public:
+		Mat3() = default;
+		constexpr Mat3(float n00)
+			:n{ { n00, n00, n00 },
+				{ n00, n00, n00 },
+				{ n00, n00, n00 } }
+		{};
+		//Arguments are in row order, storage is column major
+		constexpr Mat3(float n00, float n10, float n20,
+			float n01, float n11, float n21,
+			float n02, float n12, float n22)
+			:n{ { n00, n01, n02 },
+				{ n10, n11, n12 },
+				{ n20, n21, n22 } }
+		{};
+		//From columns
+		constexpr Mat3(const Vec3& a, const Vec3& b, const Vec3& c)
+			:n{ { a.x, a.y, a.z },
+				{ b.x, b.y, b.z },
+				{ c.x, c.y, c.z } }
+		{}
+		//Upper left 3x3 of m
+		constexpr Mat3(const Mat4& m)
+			:n{ { m.get(0, 0), m.get(0, 1), m.get(0, 2) },
+				{ m.get(1, 0), m.get(1, 1), m.get(1, 2) },
+				{ m.get(2, 0), m.get(2, 1), m.get(2, 2) } }
+		{}
+		constexpr float get(int col, int row)const {
+			return n[col][row];
+		}
+		inline Vec3& operator[](int i) {
+			return (*reinterpret_cast<Vec3*>(n[i]));
+		}
+		inline const Vec3& operator[](int i) const {
+			return (*reinterpret_cast<const Vec3*>(n[i]));
+		}
+		inline friend constexpr Vec3 operator * (const Mat3& m, const Vec3& v) {
+			return Vec3(
+				m.n[0][0] * v.x + m.n[1][0] * v.y + m.n[2][0] * v.z,
+				m.n[0][1] * v.x + m.n[1][1] * v.y + m.n[2][1] * v.z,
+				m.n[0][2] * v.x + m.n[1][2] * v.y + m.n[2][2] * v.z
+			);
+		}
+		inline friend constexpr Mat3 operator * (const Mat3& l, const Mat3& r) {
+			return Mat3(l * Vec3(r.n[0][0], r.n[0][1], r.n[0][2]),
+				l * Vec3(r.n[1][0], r.n[1][1], r.n[1][2]),
+				l * Vec3(r.n[2][0], r.n[2][1], r.n[2][2]));
+		}
+	};
+
+	inline constexpr Mat3 Transpose(const Mat3& m) {
+		return Mat3(
+			m.get(0, 0), m.get(0, 1), m.get(0, 2),
+			m.get(1, 0), m.get(1, 1), m.get(1, 2),
+			m.get(2, 0), m.get(2, 1), m.get(2, 2)
+		);
+	}
+
+	/// <summary>
+	/// Inverse transpose of the upper 3x3 of a model matrix, for transforming normals.
+	/// Correct under non-uniform scale, unlike using the model matrix directly.
+	/// </summary>
+	inline constexpr Mat3 NormalMatrix(const Mat4& model) {
+		const Vec3 a = Vec3(model.get(0, 0), model.get(0, 1), model.get(0, 2));
+		const Vec3 b = Vec3(model.get(1, 0), model.get(1, 1), model.get(1, 2));
+		const Vec3 c = Vec3(model.get(2, 0), model.get(2, 1), model.get(2, 2));
+		//Columns of inverse transpose are the rows of the inverse: cofactors / determinant
+		const Vec3 bc = Cross(b, c);
+		const float det = Dot(a, bc);
+		if (det == 0)
+			return Mat3(0.0f);
+		const float invDet = 1.0f / det;
+		return Mat3(bc * invDet, Cross(c, a) * invDet, Cross(a, b) * invDet);
+	}
+
+	//Computes count normal matrices, e.g. once per object before upload
+	inline void NormalMatrices(const Mat4* models, Mat3* out, size_t count) {
+		for (size_t i = 0; i < count; i++)
+		{
+			out[i] = NormalMatrix(models[i]);
+		}
+	}
+}
@@ -4,36 +4,41 @@
 
 #pragma once
 #include "vec4.h"
+#include "simd.h"
 #include <cstddef>
 
 namespace ew {
-	struct Mat4 {
+	//Column major, 16 byte aligned so columns can be loaded directly into SIMD registers
+	struct alignas(16) Mat4 {
 	private:
 		float n[4][4];
 	public:
 		Mat4() = default;
-		Mat4(float n00)
-		{
-			n[0][0] = n00; n[1][0] = n00; n[2][0] = n00; n[3][0] = n00;
-			n[0][1] = n00; n[1][1] = n00; n[2][1] = n00; n[3][1] = n00;
-			n[0][2] = n00; n[1][2] = n00; n[2][2] = n00; n[3][2] = n00;
-			n[0][3] = n00; n[1][3] = n00; n[2][3] = n00; n[3][3] = n00;
-		};
-		Mat4(float n00, float n10, float n20, float n30,
+		constexpr Mat4(float n00)
+			:n{ { n00, n00, n00, n00 },
+				{ n00, n00, n00, n00 },
+				{ n00, n00, n00, n00 },
+				{ n00, n00, n00, n00 } }
+		{};
+		//Arguments are in row order, storage is column major
+		constexpr Mat4(float n00, float n10, float n20, float n30,
 			 float n01, float n11, float n21, float n31,
 			 float n02, float n12, float n22, float n32,
 			 float n03, float n13, float n23, float n33)
-		{
-			n[0][0] = n00; n[1][0] = n10; n[2][0] = n20; n[3][0] = n30;
-			n[0][1] = n01; n[1][1] = n11; n[2][1] = n21; n[3][1] = n31;
-			n[0][2] = n02; n[1][2] = n12; n[2][2] = n22; n[3][2] = n32;
-			n[0][3] = n03; n[1][3] = n13; n[2][3] = n23; n[3][3] = n33;
-		};
-		Mat4(const Vec4& a, const Vec4& b, const Vec4& c, const Vec4& d) {
-			n[0][0] = a.x; n[0][1] = a.y; n[0][2] = a.z; n[0][3] = a.w;
-			n[1][0] = b.x; n[1][1] = b.y; n[1][2] = b.z; n[1][3] = b.w;
-			n[2][0] = c.x; n[2][1] = c.y; n[2][2] = c.z; n[2][3] = c.w;
-			n[3][0] = d.x; n[3][1] = d.y; n[3][2] = d.z; n[3][3] = d.w;
+			:n{ { n00, n01, n02, n03 },
+				{ n10, n11, n12, n13 },
+				{ n20, n21, n22, n23 },
+				{ n30, n31, n32, n33 } }
+		{};
+		constexpr Mat4(const Vec4& a, const Vec4& b, const Vec4& c, const Vec4& d)
+			:n{ { a.x, a.y, a.z, a.w },
+				{ b.x, b.y, b.z, b.w },
+				{ c.x, c.y, c.z, c.w },
+				{ d.x, d.y, d.z, d.w } }
+		{}
+		//Element access usable in constant expressions
+		constexpr float get(int col, int row)const {
+			return n[col][row];
 		}
 		inline Vec4& operator[](int i) {
 			return (*reinterpret_cast<Vec4*>(n[i]));
@@ -41,40 +46,69 @@ namespace ew {
 		inline const Vec4& operator[](int i) const{
 			return (*reinterpret_cast<const Vec4*>(n[i]));
 		}
-		inline friend Vec4 operator * (const Mat4& m, const Vec4& v) {
+		inline friend constexpr Vec4 operator * (const Mat4& m, const Vec4& v) {
+#if !defined(EW_SIMD_SCALAR)
+			if (!EW_IS_CONSTANT_EVALUATED()) {
+				//Linear combination of columns: m[0]*v.x + m[1]*v.y + m[2]*v.z + m[3]*v.w
+				simd::f4 c = simd::Mul(simd::LoadAligned(m.n[0]), simd::Splat(v.x));
+				c = simd::MulAdd(simd::LoadAligned(m.n[1]), simd::Splat(v.y), c);
+				c = simd::MulAdd(simd::LoadAligned(m.n[2]), simd::Splat(v.z), c);
+				c = simd::MulAdd(simd::LoadAligned(m.n[3]), simd::Splat(v.w), c);
+				Vec4 out;
+				simd::Store(&out.x, c);
+				return out;
+			}
+#endif
 			return Vec4(
-				m[0][0] * v.x + m[1][0] * v.y + m[2][0] * v.z + m[3][0] * v.w,
-				m[0][1] * v.x + m[1][1] * v.y + m[2][1] * v.z + m[3][1] * v.w,
-				m[0][2] * v.x + m[1][2] * v.y + m[2][2] * v.z + m[3][2] * v.w,
-				m[0][3] * v.x + m[1][3] * v.y + m[2][3] * v.z + m[3][3] * v.w
+				m.n[0][0] * v.x + m.n[1][0] * v.y + m.n[2][0] * v.z + m.n[3][0] * v.w,
+				m.n[0][1] * v.x + m.n[1][1] * v.y + m.n[2][1] * v.z + m.n[3][1] * v.w,
+				m.n[0][2] * v.x + m.n[1][2] * v.y + m.n[2][2] * v.z + m.n[3][2] * v.w,
+				m.n[0][3] * v.x + m.n[1][3] * v.y + m.n[2][3] * v.z + m.n[3][3] * v.w
 			);
 		}
-		inline friend Mat4 operator * (const Mat4& l, const Mat4& r) {
-			Mat4 m;
+		inline friend constexpr Mat4 operator * (const Mat4& l, const Mat4& r) {
+			Mat4 m{};
+#if !defined(EW_SIMD_SCALAR)
+			if (!EW_IS_CONSTANT_EVALUATED()) {
+				//Each result column is l * r_col
+				const simd::f4 l0 = simd::LoadAligned(l.n[0]);
+				const simd::f4 l1 = simd::LoadAligned(l.n[1]);
+				const simd::f4 l2 = simd::LoadAligned(l.n[2]);
+				const simd::f4 l3 = simd::LoadAligned(l.n[3]);
+				for (int i = 0; i < 4; i++) {
+					simd::f4 c = simd::Mul(l0, simd::Splat(r.n[i][0]));
+					c = simd::MulAdd(l1, simd::Splat(r.n[i][1]), c);
+					c = simd::MulAdd(l2, simd::Splat(r.n[i][2]), c);
+					c = simd::MulAdd(l3, simd::Splat(r.n[i][3]), c);
+					simd::StoreAligned(m.n[i], c);
+				}
+				return m;
+			}
+#endif
 			//Row 0
-			m[0][0] = l[0][0] * r[0][0] + l[1][0] * r[0][1] + l[2][0] * r[0][2] + l[3][0] * r[0][3];//dot(l_row_0,r_col_0)
-			m[1][0] = l[0][0] * r[1][0] + l[1][0] * r[1][1] + l[2][0] * r[1][2] + l[3][0] * r[1][3];//dot(l_row_0,r_col_1)
-			m[2][0] = l[0][0] * r[2][0] + l[1][0] * r[2][1] + l[2][0] * r[2][2] + l[3][0] * r[2][3];//dot(l_row_0,r_col_2)
-			m[3][0] = l[0][0] * r[3][0] + l[1][0] * r[3][1] + l[2][0] * r[3][2] + l[3][0] * r[3][3];//dot(l_row_0,r_col_3)
+			m.n[0][0] = l.n[0][0] * r.n[0][0] + l.n[1][0] * r.n[0][1] + l.n[2][0] * r.n[0][2] + l.n[3][0] * r.n[0][3];//dot(l_row_0,r_col_0)
+			m.n[1][0] = l.n[0][0] * r.n[1][0] + l.n[1][0] * r.n[1][1] + l.n[2][0] * r.n[1][2] + l.n[3][0] * r.n[1][3];//dot(l_row_0,r_col_1)
+			m.n[2][0] = l.n[0][0] * r.n[2][0] + l.n[1][0] * r.n[2][1] + l.n[2][0] * r.n[2][2] + l.n[3][0] * r.n[2][3];//dot(l_row_0,r_col_2)
+			m.n[3][0] = l.n[0][0] * r.n[3][0] + l.n[1][0] * r.n[3][1] + l.n[2][0] * r.n[3][2] + l.n[3][0] * r.n[3][3];//dot(l_row_0,r_col_3)
 			// Row 1		  		    		  		    		  		    		  
-			m[0][1] = l[0][1] * r[0][0] + l[1][1] * r[0][1] + l[2][1] * r[0][2] + l[3][1] * r[0][3];//dot(l_row_1,r_col_0)
-			m[1][1] = l[0][1] * r[1][0] + l[1][1] * r[1][1] + l[2][1] * r[1][2] + l[3][1] * r[1][3];//dot(l_row_1,r_col_1)
-			m[2][1] = l[0][1] * r[2][0] + l[1][1] * r[2][1] + l[2][1] * r[2][2] + l[3][1] * r[2][3];//dot(l_row_1,r_col_2)
-			m[3][1] = l[0][1] * r[3][0] + l[1][1] * r[3][1] + l[2][1] * r[3][2] + l[3][1] * r[3][3];//dot(l_row_1,r_col_3)
+			m.n[0][1] = l.n[0][1] * r.n[0][0] + l.n[1][1] * r.n[0][1] + l.n[2][1] * r.n[0][2] + l.n[3][1] * r.n[0][3];//dot(l_row_1,r_col_0)
+			m.n[1][1] = l.n[0][1] * r.n[1][0] + l.n[1][1] * r.n[1][1] + l.n[2][1] * r.n[1][2] + l.n[3][1] * r.n[1][3];//dot(l_row_1,r_col_1)
+			m.n[2][1] = l.n[0][1] * r.n[2][0] + l.n[1][1] * r.n[2][1] + l.n[2][1] * r.n[2][2] + l.n[3][1] * r.n[2][3];//dot(l_row_1,r_col_2)
+			m.n[3][1] = l.n[0][1] * r.n[3][0] + l.n[1][1] * r.n[3][1] + l.n[2][1] * r.n[3][2] + l.n[3][1] * r.n[3][3];//dot(l_row_1,r_col_3)
 			// Row  2		  		    		  		    		  		    		  
-			m[0][2] = l[0][2] * r[0][0] + l[1][2] * r[0][1] + l[2][2] * r[0][2] + l[3][2] * r[0][3];//dot(l_row_2,r_col_0)
-			m[1][2] = l[0][2] * r[1][0] + l[1][2] * r[1][1] + l[2][2] * r[1][2] + l[3][2] * r[1][3];//dot(l_row_2,r_col_1)
-			m[2][2] = l[0][2] * r[2][0] + l[1][2] * r[2][1] + l[2][2] * r[2][2] + l[3][2] * r[2][3];//dot(l_row_2,r_col_2)
-			m[3][2] = l[0][2] * r[3][0] + l[1][2] * r[3][1] + l[2][2] * r[3][2] + l[3][2] * r[3][3];//dot(l_row_2,r_col_3)
+			m.n[0][2] = l.n[0][2] * r.n[0][0] + l.n[1][2] * r.n[0][1] + l.n[2][2] * r.n[0][2] + l.n[3][2] * r.n[0][3];//dot(l_row_2,r_col_0)
+			m.n[1][2] = l.n[0][2] * r.n[1][0] + l.n[1][2] * r.n[1][1] + l.n[2][2] * r.n[1][2] + l.n[3][2] * r.n[1][3];//dot(l_row_2,r_col_1)
+			m.n[2][2] = l.n[0][2] * r.n[2][0] + l.n[1][2] * r.n[2][1] + l.n[2][2] * r.n[2][2] + l.n[3][2] * r.n[2][3];//dot(l_row_2,r_col_2)
+			m.n[3][2] = l.n[0][2] * r.n[3][0] + l.n[1][2] * r.n[3][1] + l.n[2][2] * r.n[3][2] + l.n[3][2] * r.n[3][3];//dot(l_row_2,r_col_3)
 			// Row  3		 			 		 			 		 			 		    
-			m[0][3] = l[0][3] * r[0][0] + l[1][3] * r[0][1] + l[2][3] * r[0][2] + l[3][3] * r[0][3];//dot(l_row_3,r_col_0)
-			m[1][3] = l[0][3] * r[1][0] + l[1][3] * r[1][1] + l[2][3] * r[1][2] + l[3][3] * r[1][3];//dot(l_row_3,r_col_1)
-			m[2][3] = l[0][3] * r[2][0] + l[1][3] * r[2][1] + l[2][3] * r[2][2] + l[3][3] * r[2][3];//dot(l_row_3,r_col_2)
-			m[3][3] = l[0][3] * r[3][0] + l[1][3] * r[3][1] + l[2][3] * r[3][2] + l[3][3] * r[3][3];//dot(l_row_3,r_col_3)
-			return m;		  
+			m.n[0][3] = l.n[0][3] * r.n[0][0] + l.n[1][3] * r.n[0][1] + l.n[2][3] * r.n[0][2] + l.n[3][3] * r.n[0][3];//dot(l_row_3,r_col_0)
+			m.n[1][3] = l.n[0][3] * r.n[1][0] + l.n[1][3] * r.n[1][1] + l.n[2][3] * r.n[1][2] + l.n[3][3] * r.n[1][3];//dot(l_row_3,r_col_1)
+			m.n[2][3] = l.n[0][3] * r.n[2][0] + l.n[1][3] * r.n[2][1] + l.n[2][3] * r.n[2][2] + l.n[3][3] * r.n[2][3];//dot(l_row_3,r_col_2)
+			m.n[3][3] = l.n[0][3] * r.n[3][0] + l.n[1][3] * r.n[3][1] + l.n[2][3] * r.n[3][2] + l.n[3][3] * r.n[3][3];//dot(l_row_3,r_col_3)
+			return m;
 		}
 	};
-	inline Mat4 IdentityMatrix() {
+	inline constexpr Mat4 IdentityMatrix() {
 		return Mat4(
 			1.0f, 0.0f, 0.0f, 0.0f,
 			0.0f, 1.0f, 0.0f, 0.0f,
@@ -82,4 +116,103 @@ namespace ew {
 			0.0f, 0.0f, 0.0f, 1.0f
 		);
 	}
+
+	inline Mat4 Transpose(const Mat4& m) {
+		Mat4 t;
+		simd::f4 c0 = simd::Load(&m[0].x);
+		simd::f4 c1 = simd::Load(&m[1].x);
+		simd::f4 c2 = simd::Load(&m[2].x);
+		simd::f4 c3 = simd::Load(&m[3].x);
+		simd::Transpose(c0, c1, c2, c3);
+		simd::Store(&t[0].x, c0);
+		simd::Store(&t[1].x, c1);
+		simd::Store(&t[2].x, c2);
+		simd::Store(&t[3].x, c3);
+		return t;
+	}
+
+	/// <summary>
+	/// Inverse of a matrix with bottom row (0,0,0,1), e.g. any TRS model matrix or view matrix.
+	/// Much cheaper than the general Inverse.
+	/// </summary>
+	inline Mat4 InverseAffine(const Mat4& m) {
+		const Vec3 a = m[0].toVec3();
+		const Vec3 b = m[1].toVec3();
+		const Vec3 c = m[2].toVec3();
+		//Rows of the inverse 3x3 are the cofactors / determinant
+		const Vec3 r0 = Cross(b, c);
+		const Vec3 r1 = Cross(c, a);
+		const Vec3 r2 = Cross(a, b);
+		const float det = Dot(a, r0);
+		if (det == 0)
+			return Mat4(0.0f);
+		const float invDet = 1.0f / det;
+		simd::f4 c0 = simd::Mul(simd::Set(r0.x, r0.y, r0.z, 0.0f), simd::Splat(invDet));
+		simd::f4 c1 = simd::Mul(simd::Set(r1.x, r1.y, r1.z, 0.0f), simd::Splat(invDet));
+		simd::f4 c2 = simd::Mul(simd::Set(r2.x, r2.y, r2.z, 0.0f), simd::Splat(invDet));
+		simd::f4 c3 = simd::Set(0.0f, 0.0f, 0.0f, 1.0f);
+		//Rows -> columns
+		simd::Transpose(c0, c1, c2, c3);
+		//Translation is -(A^-1 * t)
+		const Vec4& t = m[3];
+		simd::f4 it = simd::Mul(c0, simd::Splat(-t.x));
+		it = simd::MulAdd(c1, simd::Splat(-t.y), it);
+		it = simd::MulAdd(c2, simd::Splat(-t.z), it);
+		it = simd::Add(it, simd::Set(0.0f, 0.0f, 0.0f, 1.0f));
+
+		Mat4 inv;
+		simd::StoreAligned(&inv[0].x, c0);
+		simd::StoreAligned(&inv[1].x, c1);
+		simd::StoreAligned(&inv[2].x, c2);
+		simd::StoreAligned(&inv[3].x, it);
+		return inv;
+	}
+
+	/// <summary>
+	/// General 4x4 inverse (e.g. projection or view projection). Returns Mat4(0) if m is singular.
+	/// </summary>
+	inline Mat4 Inverse(const Mat4& m) {
+		//2x2 sub determinants of the first two (s) and last two (c) columns. The expansion is
+		//symmetric under transpose, so it applies directly to column major storage.
+		const float s0 = m[0][0] * m[1][1] - m[1][0] * m[0][1];
+		const float s1 = m[0][0] * m[1][2] - m[1][0] * m[0][2];
+		const float s2 = m[0][0] * m[1][3] - m[1][0] * m[0][3];
+		const float s3 = m[0][1] * m[1][2] - m[1][1] * m[0][2];
+		const float s4 = m[0][1] * m[1][3] - m[1][1] * m[0][3];
+		const float s5 = m[0][2] * m[1][3] - m[1][2] * m[0][3];
+
+		const float c5 = m[2][2] * m[3][3] - m[3][2] * m[2][3];
+		const float c4 = m[2][1] * m[3][3] - m[3][1] * m[2][3];
+		const float c3 = m[2][1] * m[3][2] - m[3][1] * m[2][2];
+		const float c2 = m[2][0] * m[3][3] - m[3][0] * m[2][3];
+		const float c1 = m[2][0] * m[3][2] - m[3][0] * m[2][2];
+		const float c0 = m[2][0] * m[3][1] - m[3][0] * m[2][1];
+
+		const float det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+		if (det == 0)
+			return Mat4(0.0f);
+		const float invDet = 1.0f / det;
+
+		Mat4 inv;
+		inv[0][0] = (m[1][1] * c5 - m[1][2] * c4 + m[1][3] * c3) * invDet;
+		inv[0][1] = (-m[0][1] * c5 + m[0][2] * c4 - m[0][3] * c3) * invDet;
+		inv[0][2] = (m[3][1] * s5 - m[3][2] * s4 + m[3][3] * s3) * invDet;
+		inv[0][3] = (-m[2][1] * s5 + m[2][2] * s4 - m[2][3] * s3) * invDet;
+
+		inv[1][0] = (-m[1][0] * c5 + m[1][2] * c2 - m[1][3] * c1) * invDet;
+		inv[1][1] = (m[0][0] * c5 - m[0][2] * c2 + m[0][3] * c1) * invDet;
+		inv[1][2] = (-m[3][0] * s5 + m[3][2] * s2 - m[3][3] * s1) * invDet;
+		inv[1][3] = (m[2][0] * s5 - m[2][2] * s2 + m[2][3] * s1) * invDet;
+
+		inv[2][0] = (m[1][0] * c4 - m[1][1] * c2 + m[1][3] * c0) * invDet;
+		inv[2][1] = (-m[0][0] * c4 + m[0][1] * c2 - m[0][3] * c0) * invDet;
+		inv[2][2] = (m[3][0] * s4 - m[3][1] * s2 + m[3][3] * s0) * invDet;
+		inv[2][3] = (-m[2][0] * s4 + m[2][1] * s2 - m[2][3] * s0) * invDet;
+
+		inv[3][0] = (-m[1][0] * c3 + m[1][1] * c1 - m[1][2] * c0) * invDet;
+		inv[3][1] = (m[0][0] * c3 - m[0][1] * c1 + m[0][2] * c0) * invDet;
+		inv[3][2] = (-m[3][0] * s3 + m[3][1] * s1 - m[3][2] * s0) * invDet;
+		inv[3][3] = (m[2][0] * s3 - m[2][1] * s1 + m[2][2] * s0) * invDet;
+		return inv;
+	}
 }
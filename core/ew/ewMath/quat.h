@@ -0,0 +1,120 @@
+#pragma once
+#include <math.h>
+#include "vec3.h"
+#include "mat4.h"
+
+namespace ew {
+	//Unit quaternion rotation. xyz = vector part, w = scalar part
+	struct Quat {
+		float x, y, z, w;
+
+		constexpr Quat() :x(0), y(0), z(0), w(1) {};
+		constexpr Quat(float x, float y, float z, float w) :x(x), y(y), z(z), w(w) {};
+
+		friend constexpr Quat operator*(const Quat& lhs, const Quat& rhs);
+	};
+
+	//Hamilton product. Applies rhs first, then lhs
+	inline constexpr Quat operator*(const Quat& lhs, const Quat& rhs)
+	{
+		return Quat(
+			lhs.w * rhs.x + lhs.x * rhs.w + lhs.y * rhs.z - lhs.z * rhs.y,
+			lhs.w * rhs.y - lhs.x * rhs.z + lhs.y * rhs.w + lhs.z * rhs.x,
+			lhs.w * rhs.z + lhs.x * rhs.y - lhs.y * rhs.x + lhs.z * rhs.w,
+			lhs.w * rhs.w - lhs.x * rhs.x - lhs.y * rhs.y - lhs.z * rhs.z
+		);
+	}
+
+	//Utility functions
+	inline constexpr float Dot(const Quat& a, const Quat& b) {
+		return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+	}
+
+	inline Quat Normalize(const Quat& q)
+	{
+		float mag = sqrtf(Dot(q, q));
+		if (mag == 0)
+			return Quat();
+		float invMag = 1.0f / mag;
+		return Quat(q.x * invMag, q.y * invMag, q.z * invMag, q.w * invMag);
+	}
+
+	//Inverse rotation of a unit quaternion
+	inline constexpr Quat Conjugate(const Quat& q) {
+		return Quat(-q.x, -q.y, -q.z, q.w);
+	}
+
+	//Rotation of rad radians around a normalized axis
+	inline Quat AxisAngle(const Vec3& axis, float rad) {
+		const float s = sinf(rad * 0.5f);
+		return Quat(axis.x * s, axis.y * s, axis.z * s, cosf(rad * 0.5f));
+	}
+
+	//Euler angles in radians, same order as Transform (RotateY * RotateX * RotateZ)
+	inline Quat QuatFromEuler(const Vec3& euler) {
+		const float cx = cosf(euler.x * 0.5f), sx = sinf(euler.x * 0.5f);
+		const float cy = cosf(euler.y * 0.5f), sy = sinf(euler.y * 0.5f);
+		const float cz = cosf(euler.z * 0.5f), sz = sinf(euler.z * 0.5f);
+		return Quat(
+			cy * sx * cz + sy * cx * sz,
+			sy * cx * cz - cy * sx * sz,
+			cy * cx * sz - sy * sx * cz,
+			cy * cx * cz + sy * sx * sz
+		);
+	}
+
+	//Rotates v by q
+	inline Vec3 Rotate(const Quat& q, const Vec3& v) {
+		const Vec3 u = Vec3(q.x, q.y, q.z);
+		const Vec3 t = Cross(u, v) * 2.0f;
+		return v + t * q.w + Cross(u, t);
+	}
+
+	/// <summary>
+	/// Normalized linear interpolation along the shortest arc. Cheaper than Slerp and fine for small steps.
+	/// </summary>
+	inline Quat Nlerp(const Quat& a, const Quat& b, float t) {
+		const float sign = Dot(a, b) < 0 ? -1.0f : 1.0f;
+		return Normalize(Quat(
+			a.x + (b.x * sign - a.x) * t,
+			a.y + (b.y * sign - a.y) * t,
+			a.z + (b.z * sign - a.z) * t,
+			a.w + (b.w * sign - a.w) * t
+		));
+	}
+
+	/// <summary>
+	/// Spherical linear interpolation along the shortest arc (constant angular velocity)
+	/// </summary>
+	inline Quat Slerp(const Quat& a, const Quat& b, float t) {
+		float cosTheta = Dot(a, b);
+		const float sign = cosTheta < 0 ? -1.0f : 1.0f;
+		cosTheta *= sign;
+		//Nearly parallel, sin(theta) would divide by ~0
+		if (cosTheta > 0.9995f)
+			return Nlerp(a, b, t);
+		const float theta = acosf(cosTheta);
+		const float invSin = 1.0f / sinf(theta);
+		const float wa = sinf((1.0f - t) * theta) * invSin;
+		const float wb = sinf(t * theta) * invSin * sign;
+		return Quat(
+			a.x * wa + b.x * wb,
+			a.y * wa + b.y * wb,
+			a.z * wa + b.z * wb,
+			a.w * wa + b.w * wb
+		);
+	}
+
+	//Rotation matrix of a unit quaternion
+	inline Mat4 ToMat4(const Quat& q) {
+		const float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+		const float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+		const float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+		return Mat4(
+			1.0f - 2.0f * (yy + zz), 2.0f * (xy - wz), 2.0f * (xz + wy), 0.0f,
+			2.0f * (xy + wz), 1.0f - 2.0f * (xx + zz), 2.0f * (yz - wx), 0.0f,
+			2.0f * (xz - wy), 2.0f * (yz + wx), 1.0f - 2.0f * (xx + yy), 0.0f,
+			0.0f, 0.0f, 0.0f, 1.0f
+		);
+	}
+}
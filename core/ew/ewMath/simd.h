@@ -0,0 +1,115 @@
+#pragma once
+
+//Compile time selection of the 4-wide float backend used by the math library.
+//Define EW_SIMD_DISABLE to force the scalar fallback.
+#if !defined(EW_SIMD_DISABLE) && (defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1))
+#define EW_SIMD_SSE 1
+#include <xmmintrin.h>
+#if defined(__FMA__) || defined(__AVX2__)
+#define EW_SIMD_FMA 1
+#include <immintrin.h>
+#endif
+#elif !defined(EW_SIMD_DISABLE) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#define EW_SIMD_NEON 1
+#include <arm_neon.h>
+#else
+#define EW_SIMD_SCALAR 1
+#include <math.h>
+#endif
+
+//True while a constexpr function is being evaluated by the compiler, so it can take a scalar
+//path instead of intrinsics or libm calls.
+#if defined(__GNUC__) || defined(__clang__) || (defined(_MSC_VER) && _MSC_VER >= 1925)
+#define EW_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#define EW_HAS_CONSTANT_EVALUATED 1 //Trig and Mat4 products fold at compile time
+#else
+#define EW_IS_CONSTANT_EVALUATED() false
+#endif
+
+namespace ew {
+	namespace simd {
+#if defined(EW_SIMD_SSE)
+		typedef __m128 f4;
+		inline f4 Load(const float* p) { return _mm_loadu_ps(p); }
+		inline f4 LoadAligned(const float* p) { return _mm_load_ps(p); }
+		inline void Store(float* p, f4 v) { _mm_storeu_ps(p, v); }
+		inline void StoreAligned(float* p, f4 v) { _mm_store_ps(p, v); }
+		inline f4 Splat(float x) { return _mm_set1_ps(x); }
+		inline f4 Set(float x, float y, float z, float w) { return _mm_setr_ps(x, y, z, w); }
+		inline f4 Add(f4 a, f4 b) { return _mm_add_ps(a, b); }
+		inline f4 Sub(f4 a, f4 b) { return _mm_sub_ps(a, b); }
+		inline f4 Mul(f4 a, f4 b) { return _mm_mul_ps(a, b); }
+		inline f4 Min(f4 a, f4 b) { return _mm_min_ps(a, b); }
+		inline f4 Max(f4 a, f4 b) { return _mm_max_ps(a, b); }
+		//a * b + c
+		inline f4 MulAdd(f4 a, f4 b, f4 c) {
+#if defined(EW_SIMD_FMA)
+			return _mm_fmadd_ps(a, b, c);
+#else
+			return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+		}
+		//Swaps rows and columns of the 4x4 block formed by a,b,c,d
+		inline void Transpose(f4& a, f4& b, f4& c, f4& d) { _MM_TRANSPOSE4_PS(a, b, c, d); }
+#elif defined(EW_SIMD_NEON)
+		typedef float32x4_t f4;
+		inline f4 Load(const float* p) { return vld1q_f32(p); }
+		inline f4 LoadAligned(const float* p) { return vld1q_f32(p); }
+		inline void Store(float* p, f4 v) { vst1q_f32(p, v); }
+		inline void StoreAligned(float* p, f4 v) { vst1q_f32(p, v); }
+		inline f4 Splat(float x) { return vdupq_n_f32(x); }
+		inline f4 Set(float x, float y, float z, float w) {
+			const float v[4] = { x, y, z, w };
+			return vld1q_f32(v);
+		}
+		inline f4 Add(f4 a, f4 b) { return vaddq_f32(a, b); }
+		inline f4 Sub(f4 a, f4 b) { return vsubq_f32(a, b); }
+		inline f4 Mul(f4 a, f4 b) { return vmulq_f32(a, b); }
+		inline f4 Min(f4 a, f4 b) { return vminq_f32(a, b); }
+		inline f4 Max(f4 a, f4 b) { return vmaxq_f32(a, b); }
+		//a * b + c
+		inline f4 MulAdd(f4 a, f4 b, f4 c) { return vmlaq_f32(c, a, b); }
+		//Swaps rows and columns of the 4x4 block formed by a,b,c,d
+		inline void Transpose(f4& a, f4& b, f4& c, f4& d) {
+			float32x4x2_t ab = vtrnq_f32(a, b);
+			float32x4x2_t cd = vtrnq_f32(c, d);
+			a = vcombine_f32(vget_low_f32(ab.val[0]), vget_low_f32(cd.val[0]));
+			b = vcombine_f32(vget_low_f32(ab.val[1]), vget_low_f32(cd.val[1]));
+			c = vcombine_f32(vget_high_f32(ab.val[0]), vget_high_f32(cd.val[0]));
+			d = vcombine_f32(vget_high_f32(ab.val[1]), vget_high_f32(cd.val[1]));
+		}
+#else
+		struct f4 {
+			float v[4];
+		};
+		inline f4 Load(const float* p) { return f4{ { p[0], p[1], p[2], p[3] } }; }
+		inline f4 LoadAligned(const float* p) { return Load(p); }
+		inline void Store(float* p, f4 v) { p[0] = v.v[0]; p[1] = v.v[1]; p[2] = v.v[2]; p[3] = v.v[3]; }
+		inline void StoreAligned(float* p, f4 v) { Store(p, v); }
+		inline f4 Splat(float x) { return f4{ { x, x, x, x } }; }
+		inline f4 Set(float x, float y, float z, float w) { return f4{ { x, y, z, w } }; }
+		inline f4 Add(f4 a, f4 b) { return f4{ { a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3] } }; }
+		inline f4 Sub(f4 a, f4 b) { return f4{ { a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3] } }; }
+		inline f4 Mul(f4 a, f4 b) { return f4{ { a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3] } }; }
+		inline f4 Min(f4 a, f4 b) { return f4{ { fminf(a.v[0], b.v[0]), fminf(a.v[1], b.v[1]), fminf(a.v[2], b.v[2]), fminf(a.v[3], b.v[3]) } }; }
+		inline f4 Max(f4 a, f4 b) { return f4{ { fmaxf(a.v[0], b.v[0]), fmaxf(a.v[1], b.v[1]), fmaxf(a.v[2], b.v[2]), fmaxf(a.v[3], b.v[3]) } }; }
+		//a * b + c
+		inline f4 MulAdd(f4 a, f4 b, f4 c) { return Add(Mul(a, b), c); }
+		//Swaps rows and columns of the 4x4 block formed by a,b,c,d
+		inline void Transpose(f4& a, f4& b, f4& c, f4& d) {
+			f4 r[4] = { a, b, c, d };
+			a = f4{ { r[0].v[0], r[1].v[0], r[2].v[0], r[3].v[0] } };
+			b = f4{ { r[0].v[1], r[1].v[1], r[2].v[1], r[3].v[1] } };
+			c = f4{ { r[0].v[2], r[1].v[2], r[2].v[2], r[3].v[2] } };
+			d = f4{ { r[0].v[3], r[1].v[3], r[2].v[3], r[3].v[3] } };
+		}
+#endif
+
+		inline f4 Abs(f4 a) { return Max(a, Sub(Splat(0.0f), a)); }
+		//Round to nearest, valid for |a| < 2^22
+		inline f4 Round(f4 a) {
+			const f4 magic = Splat(12582912.0f); //1.5 * 2^23
+			return Sub(Add(a, magic), magic);
+		}
+	}
+}
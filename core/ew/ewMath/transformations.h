@@ -5,10 +5,12 @@
 #pragma once
 #include "mat4.h"
 #include "vec3.h"
+#include "quat.h"
+#include "trig.h"
 
 namespace ew {
 	//Identity matrix
-	inline ew::Mat4 Identity() {
+	inline constexpr ew::Mat4 Identity() {
 		return ew::Mat4(
 			1, 0, 0, 0,
 			0, 1, 0, 0,
@@ -17,7 +19,7 @@ namespace ew {
 		);
 	};
 	//Scale on x,y,z axes
-	inline ew::Mat4 Scale(const ew::Vec3& s) {
+	inline constexpr ew::Mat4 Scale(const ew::Vec3& s) {
 		return ew::Mat4(
 			s.x, 0, 0, 0,
 			0, s.y, 0, 0,
@@ -26,9 +28,9 @@ namespace ew {
 		);
 	};
 	//Rotation around X axis (pitch) in radians
-	inline ew::Mat4 RotateX(float rad) {
-		const float cosA = cosf(rad);
-		const float sinA = sinf(rad);
+	inline constexpr ew::Mat4 RotateX(float rad) {
+		float sinA = 0.0f, cosA = 0.0f;
+		ew::SinCos(rad, sinA, cosA);
 		return Mat4(
 			1.0f, 0.0f, 0.0f, 0.0f,
 			0.0f, cosA, -sinA, 0.0f,
@@ -37,9 +39,9 @@ namespace ew {
 		);
 	};
 	//Rotation around Y axis (yaw) in radians
-	inline ew::Mat4 RotateY(float rad) {
-		const float cosA = cosf(rad);
-		const float sinA = sinf(rad);
+	inline constexpr ew::Mat4 RotateY(float rad) {
+		float sinA = 0.0f, cosA = 0.0f;
+		ew::SinCos(rad, sinA, cosA);
 		return Mat4(
 			cosA, 0.0f, sinA, 0.0f,
 			0.0f, 1.0f, 0.0f, 0.0f,
@@ -48,9 +50,9 @@ namespace ew {
 		);
 	};
 	//Rotation around Z axis (roll) in radians
-	inline ew::Mat4 RotateZ(float rad) {
-		const float cosA = cosf(rad);
-		const float sinA = sinf(rad);
+	inline constexpr ew::Mat4 RotateZ(float rad) {
+		float sinA = 0.0f, cosA = 0.0f;
+		ew::SinCos(rad, sinA, cosA);
 		return Mat4(
 			cosA, -sinA, 0.0f, 0.0f,
 			sinA, cosA, 0.0f, 0.0f,
@@ -59,7 +61,7 @@ namespace ew {
 		);
 	};
 	//Translate x,y,z
-	inline ew::Mat4 Translate(const ew::Vec3& t) {
+	inline constexpr ew::Mat4 Translate(const ew::Vec3& t) {
 		return Mat4(
 			1.0f, 0.0f, 0.0f, t.x,
 			0.0f, 1.0f, 0.0f, t.y,
@@ -68,6 +70,34 @@ namespace ew {
 		);
 	};
 
+	//Translate * RotateY * RotateX * RotateZ * Scale, assembled directly without intermediate products.
+	//Euler angles in radians
+	inline constexpr ew::Mat4 TRS(const ew::Vec3& t, const ew::Vec3& euler, const ew::Vec3& s) {
+		float sx = 0.0f, cx = 0.0f, sy = 0.0f, cy = 0.0f, sz = 0.0f, cz = 0.0f;
+		ew::SinCos(euler.x, sx, cx);
+		ew::SinCos(euler.y, sy, cy);
+		ew::SinCos(euler.z, sz, cz);
+		return Mat4(
+			(cy * cz + sy * sx * sz) * s.x, (sy * sx * cz - cy * sz) * s.y, sy * cx * s.z, t.x,
+			cx * sz * s.x, cx * cz * s.y, -sx * s.z, t.y,
+			(cy * sx * sz - sy * cz) * s.x, (sy * sz + cy * sx * cz) * s.y, cy * cx * s.z, t.z,
+			0.0f, 0.0f, 0.0f, 1.0f
+		);
+	}
+
+	//Translate * ToMat4(q) * Scale, assembled directly without intermediate products
+	inline constexpr ew::Mat4 TRS(const ew::Vec3& t, const ew::Quat& q, const ew::Vec3& s) {
+		const float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+		const float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+		const float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+		return Mat4(
+			(1.0f - 2.0f * (yy + zz)) * s.x, 2.0f * (xy - wz) * s.y, 2.0f * (xz + wy) * s.z, t.x,
+			2.0f * (xy + wz) * s.x, (1.0f - 2.0f * (xx + zz)) * s.y, 2.0f * (yz - wx) * s.z, t.y,
+			2.0f * (xz - wy) * s.x, 2.0f * (yz + wx) * s.y, (1.0f - 2.0f * (xx + yy)) * s.z, t.z,
+			0.0f, 0.0f, 0.0f, 1.0f
+		);
+	}
+
 	inline ew::Mat4 LookAt(const ew::Vec3& eyePos, const ew::Vec3& targetPos, const ew::Vec3& up) {
 		ew::Vec3 f = ew::Normalize(eyePos - targetPos);
 		ew::Vec3 r = ew::Normalize(ew::Cross(up, f));
@@ -80,32 +110,28 @@ namespace ew {
 		return m;
 	}
 
-	inline ew::Mat4 Perspective(float fov, float a, float n, float f) {
-		float c = tanf(fov / 2.0f);
-		Mat4 m = Mat4(0);
-		m[0][0] = 1.0f / (c * a); //Scale X
-		m[1][1] = 1.0f / c; //Scale Y
-		m[2][2] = (f + n) / (n-f); //Scale Z
-		m[3][2] = (2 * f * n) / (n-f); //Translate Z
-		m[2][3] = -1.0f; //Perspective divide (puts Z in W component of vector)
-		return m;
+	inline constexpr ew::Mat4 Perspective(float fov, float a, float n, float f) {
+		const float c = ew::Tan(fov / 2.0f);
+		return Mat4(
+			1.0f / (c * a), 0.0f, 0.0f, 0.0f, //Scale X
+			0.0f, 1.0f / c, 0.0f, 0.0f, //Scale Y
+			0.0f, 0.0f, (f + n) / (n - f), (2 * f * n) / (n - f), //Scale Z, Translate Z
+			0.0f, 0.0f, -1.0f, 0.0f //Perspective divide (puts Z in W component of vector)
+		);
 	}
 
-	inline ew::Mat4 Orthographic(float height, float a, float n, float f) {
+	inline constexpr ew::Mat4 Orthographic(float height, float a, float n, float f) {
 		//Symmetrical bounds based on aspect ratio
-		float t = height / 2;
-		float b = -t;
-		float r = (height * a) / 2;
-		float l = -r;
+		const float t = height / 2;
+		const float b = -t;
+		const float r = (height * a) / 2;
+		const float l = -r;
 
-		Mat4 m = Mat4(0);
-		m[0][0] = 2 / (r - l);
-		m[1][1] = 2 / (t - b);
-		m[2][2] = -2 / (f - n);
-		m[3][0] = -(r + l) / (r - l);
-		m[3][1] = -(t + b) / (t - b);
-		m[3][2] = -(f + n) / (f - n);
-		m[3][3] = 1.0f;
-		return m;
+		return Mat4(
+			2 / (r - l), 0.0f, 0.0f, -(r + l) / (r - l),
+			0.0f, 2 / (t - b), 0.0f, -(t + b) / (t - b),
+			0.0f, 0.0f, -2 / (f - n), -(f + n) / (f - n),
+			0.0f, 0.0f, 0.0f, 1.0f
+		);
 	}
 }
@@ -0,0 +1,133 @@
+#pragma once
+#include <math.h>
+#include <cstddef>
+#include "simd.h"
+
+namespace ew {
+	//Compile time trig for constant angles. Use sinf/cosf at runtime, these are slow.
+	namespace ct {
+		//Wraps x to [-PI, PI]
+		constexpr double WrapAngle(double x) {
+			const double tau = 6.283185307179586;
+			double k = x / tau;
+			long long n = (long long)(k < 0 ? k - 0.5 : k + 0.5);
+			return x - (double)n * tau;
+		}
+		//Taylor series, accurate to float precision after wrapping
+		constexpr double SinSeries(double x) {
+			double term = x;
+			double sum = x;
+			for (int i = 1; i < 12; i++) {
+				term *= -x * x / ((2 * i) * (2 * i + 1));
+				sum += term;
+			}
+			return sum;
+		}
+		constexpr float Sin(float rad) {
+			return (float)SinSeries(WrapAngle(rad));
+		}
+		constexpr float Cos(float rad) {
+			return (float)SinSeries(WrapAngle(rad + 1.5707963267948966));
+		}
+		constexpr float Tan(float rad) {
+			const double x = WrapAngle(rad);
+			return (float)(SinSeries(x) / SinSeries(WrapAngle(x + 1.5707963267948966)));
+		}
+	}
+
+	//Trig that folds to a constant when called in a constant expression
+	constexpr float Sin(float rad) {
+		return EW_IS_CONSTANT_EVALUATED() ? ct::Sin(rad) : sinf(rad);
+	}
+	constexpr float Cos(float rad) {
+		return EW_IS_CONSTANT_EVALUATED() ? ct::Cos(rad) : cosf(rad);
+	}
+	constexpr float Tan(float rad) {
+		return EW_IS_CONSTANT_EVALUATED() ? ct::Tan(rad) : tanf(rad);
+	}
+
+	enum class TrigAccuracy {
+		FAST = 0, //Polynomial approximation, ~2e-7 absolute error, vectorized
+		ACCURATE = 1 //libm sinf/cosf
+	};
+
+	namespace simd {
+		/// <summary>
+		/// Sine and cosine of 4 angles (radians) from a single range reduction.
+		/// Accurate to ~2e-7 for |rad| < ~1e4.
+		/// </summary>
+		inline void SinCos(f4 rad, f4& s, f4& c) {
+			//rad = q * PI + r, r in [-PI/2, PI/2]. PI split in two so q * PI_A is exact.
+			const f4 q = Round(Mul(rad, Splat(0.318309886f)));
+			f4 r = Sub(rad, Mul(q, Splat(3.140625f)));
+			r = Sub(r, Mul(q, Splat(9.67653589793e-4f)));
+			//(-1)^q: 1 when q is even, -1 when odd
+			const f4 half = Mul(q, Splat(0.5f));
+			const f4 odd = Mul(Abs(Sub(half, Round(half))), Splat(2.0f));
+			const f4 sign = Sub(Splat(1.0f), Mul(odd, Splat(2.0f)));
+
+			const f4 r2 = Mul(r, r);
+			//Taylor series to r^11 / r^12, error below float precision on [-PI/2, PI/2]
+			f4 ps = Splat(-2.50521084e-8f);
+			ps = MulAdd(ps, r2, Splat(2.75573192e-6f));
+			ps = MulAdd(ps, r2, Splat(-1.98412698e-4f));
+			ps = MulAdd(ps, r2, Splat(8.33333333e-3f));
+			ps = MulAdd(ps, r2, Splat(-1.66666667e-1f));
+			ps = MulAdd(Mul(ps, r2), r, r);
+
+			f4 pc = Splat(2.08767570e-9f);
+			pc = MulAdd(pc, r2, Splat(-2.75573192e-7f));
+			pc = MulAdd(pc, r2, Splat(2.48015873e-5f));
+			pc = MulAdd(pc, r2, Splat(-1.38888889e-3f));
+			pc = MulAdd(pc, r2, Splat(4.16666667e-2f));
+			pc = MulAdd(pc, r2, Splat(-0.5f));
+			pc = MulAdd(pc, r2, Splat(1.0f));
+
+			s = Mul(ps, sign);
+			c = Mul(pc, sign);
+		}
+	}
+
+	/// <summary>
+	/// Sine and cosine of one angle (radians) from a single range reduction.
+	/// </summary>
+	constexpr void SinCos(float rad, float& s, float& c, TrigAccuracy accuracy = TrigAccuracy::FAST) {
+		if (EW_IS_CONSTANT_EVALUATED()) {
+			s = ct::Sin(rad);
+			c = ct::Cos(rad);
+		}
+		else if (accuracy == TrigAccuracy::ACCURATE) {
+			s = sinf(rad);
+			c = cosf(rad);
+		}
+		else {
+			simd::f4 vs = simd::Splat(0.0f), vc = simd::Splat(0.0f);
+			simd::SinCos(simd::Splat(rad), vs, vc);
+			float sOut[4] = {}, cOut[4] = {};
+			simd::Store(sOut, vs);
+			simd::Store(cOut, vc);
+			s = sOut[0];
+			c = cOut[0];
+		}
+	}
+
+	/// <summary>
+	/// Sine and cosine of count angles (radians). Outputs may not alias the input.
+	/// </summary>
+	inline void SinCosN(const float* rad, float* s, float* c, size_t count, TrigAccuracy accuracy = TrigAccuracy::FAST) {
+		size_t i = 0;
+		if (accuracy == TrigAccuracy::FAST) {
+			for (; i + 4 <= count; i += 4)
+			{
+				simd::f4 vs, vc;
+				simd::SinCos(simd::Load(rad + i), vs, vc);
+				simd::Store(s + i, vs);
+				simd::Store(c + i, vc);
+			}
+		}
+		for (; i < count; i++)
+		{
+			SinCos(rad[i], s[i], c[i], accuracy);
+		}
+	}
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include <cstddef>
+#include "vec3.h"
+#include "mat4.h"
+#include "simd.h"
+
+//In place operations over arrays of Vec3, for mesh processing loops.
+//Vec3 is 3 tightly packed floats, so element wise ops run over the flat float array 4 lanes at a time.
+namespace ew {
+	//dst[i] += src[i]
+	inline void AddN(Vec3* dst, const Vec3* src, size_t count) {
+		float* d = &dst->x;
+		const float* s = &src->x;
+		const size_t n = count * 3;
+		size_t i = 0;
+		for (; i + 4 <= n; i += 4)
+			simd::Store(d + i, simd::Add(simd::Load(d + i), simd::Load(s + i)));
+		for (; i < n; i++)
+			d[i] += s[i];
+	}
+
+	//dst[i] *= s
+	inline void ScaleN(Vec3* dst, float s, size_t count) {
+		float* d = &dst->x;
+		const size_t n = count * 3;
+		const simd::f4 vs = simd::Splat(s);
+		size_t i = 0;
+		for (; i + 4 <= n; i += 4)
+			simd::Store(d + i, simd::Mul(simd::Load(d + i), vs));
+		for (; i < n; i++)
+			d[i] *= s;
+	}
+
+	//dst[i] += src[i] * s
+	inline void ScaleAddN(Vec3* dst, const Vec3* src, float s, size_t count) {
+		float* d = &dst->x;
+		const float* a = &src->x;
+		const size_t n = count * 3;
+		const simd::f4 vs = simd::Splat(s);
+		size_t i = 0;
+		for (; i + 4 <= n; i += 4)
+			simd::Store(d + i, simd::MulAdd(simd::Load(a + i), vs, simd::Load(d + i)));
+		for (; i < n; i++)
+			d[i] += a[i] * s;
+	}
+
+	//v[i] = Normalize(v[i]). Zero length vectors are left as is
+	inline void NormalizeN(Vec3* v, size_t count) {
+		for (size_t i = 0; i < count; i++)
+		{
+			const float magSq = Dot(v[i], v[i]);
+			const float invMag = magSq > 0 ? 1.0f / sqrtf(magSq) : 1.0f;
+			v[i].x *= invMag;
+			v[i].y *= invMag;
+			v[i].z *= invMag;
+		}
+	}
+
+	//out[i] = Cross(a[i], b[i]). out may alias a or b
+	inline void CrossN(const Vec3* a, const Vec3* b, Vec3* out, size_t count) {
+		for (size_t i = 0; i < count; i++)
+		{
+			out[i] = Cross(a[i], b[i]);
+		}
+	}
+
+	//points[i] = (m * Vec4(points[i], 1)).xyz
+	inline void TransformPointsN(const Mat4& m, Vec3* points, size_t count) {
+		const simd::f4 c0 = simd::LoadAligned(&m[0].x);
+		const simd::f4 c1 = simd::LoadAligned(&m[1].x);
+		const simd::f4 c2 = simd::LoadAligned(&m[2].x);
+		const simd::f4 c3 = simd::LoadAligned(&m[3].x);
+		float out[4];
+		for (size_t i = 0; i < count; i++)
+		{
+			simd::f4 p = simd::MulAdd(c0, simd::Splat(points[i].x), c3);
+			p = simd::MulAdd(c1, simd::Splat(points[i].y), p);
+			p = simd::MulAdd(c2, simd::Splat(points[i].z), p);
+			simd::Store(out, p);
+			points[i] = Vec3(out[0], out[1], out[2]);
+		}
+	}
+}
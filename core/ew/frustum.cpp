@@ -0,0 +1,157 @@
+#include "frustum.h"
+#include "ewMath/simd.h"
+
+namespace ew {
+	static_assert(sizeof(BoundingSphere) == 4 * sizeof(float), "CullSpheres loads one sphere per register");
+
+	static Plane normalizePlane(float a, float b, float c, float d) {
+		float invMag = 1.0f / sqrtf(a * a + b * b + c * c);
+		return Plane{ ew::Vec3(a, b, c) * invMag, d * invMag };
+	}
+	Frustum ExtractFrustum(const ew::Mat4& m)
+	{
+		//Rows of the matrix. Clip space is -w <= x,y,z <= w
+		ew::Vec4 r0 = ew::Vec4(m[0][0], m[1][0], m[2][0], m[3][0]);
+		ew::Vec4 r1 = ew::Vec4(m[0][1], m[1][1], m[2][1], m[3][1]);
+		ew::Vec4 r2 = ew::Vec4(m[0][2], m[1][2], m[2][2], m[3][2]);
+		ew::Vec4 r3 = ew::Vec4(m[0][3], m[1][3], m[2][3], m[3][3]);
+		Frustum f;
+		f.planes[0] = normalizePlane(r3.x + r0.x, r3.y + r0.y, r3.z + r0.z, r3.w + r0.w); //Left
+		f.planes[1] = normalizePlane(r3.x - r0.x, r3.y - r0.y, r3.z - r0.z, r3.w - r0.w); //Right
+		f.planes[2] = normalizePlane(r3.x + r1.x, r3.y + r1.y, r3.z + r1.z, r3.w + r1.w); //Bottom
+		f.planes[3] = normalizePlane(r3.x - r1.x, r3.y - r1.y, r3.z - r1.z, r3.w - r1.w); //Top
+		f.planes[4] = normalizePlane(r3.x + r2.x, r3.y + r2.y, r3.z + r2.z, r3.w + r2.w); //Near
+		f.planes[5] = normalizePlane(r3.x - r2.x, r3.y - r2.y, r3.z - r2.z, r3.w - r2.w); //Far
+		return f;
+	}
+	AABB TransformAABB(const AABB& box, const ew::Mat4& m)
+	{
+		//Arvo: new extents are |M| * extents
+		ew::Vec3 c = (m * ew::Vec4(box.center(), 1.0f)).toVec3();
+		ew::Vec3 e = box.extents();
+		ew::Vec3 x = m[0].toVec3(), y = m[1].toVec3(), z = m[2].toVec3();
+		ew::Vec3 ext = ew::Vec3(
+			fabsf(x.x) * e.x + fabsf(y.x) * e.y + fabsf(z.x) * e.z,
+			fabsf(x.y) * e.x + fabsf(y.y) * e.y + fabsf(z.y) * e.z,
+			fabsf(x.z) * e.x + fabsf(y.z) * e.y + fabsf(z.z) * e.z
+		);
+		return AABB{ c - ext, c + ext };
+	}
+	BoundingSphere TransformSphere(const BoundingSphere& sphere, const ew::Mat4& m)
+	{
+		//Scale radius by the largest axis scale
+		float sx = ew::Dot(m[0].toVec3(), m[0].toVec3());
+		float sy = ew::Dot(m[1].toVec3(), m[1].toVec3());
+		float sz = ew::Dot(m[2].toVec3(), m[2].toVec3());
+		float maxScale = sqrtf(fmaxf(sx, fmaxf(sy, sz)));
+		return BoundingSphere{ (m * ew::Vec4(sphere.center, 1.0f)).toVec3(), sphere.radius * maxScale };
+	}
+	bool IsVisible(const Frustum& frustum, const AABB& box)
+	{
+		ew::Vec3 c = box.center();
+		ew::Vec3 e = box.extents();
+		for (int i = 0; i < 6; i++)
+		{
+			const Plane& p = frustum.planes[i];
+			float r = fabsf(p.normal.x) * e.x + fabsf(p.normal.y) * e.y + fabsf(p.normal.z) * e.z;
+			if (ew::Dot(p.normal, c) + p.distance + r < 0)
+				return false;
+		}
+		return true;
+	}
+	bool IsVisible(const Frustum& frustum, const BoundingSphere& sphere)
+	{
+		for (int i = 0; i < 6; i++)
+		{
+			const Plane& p = frustum.planes[i];
+			if (ew::Dot(p.normal, sphere.center) + p.distance + sphere.radius < 0)
+				return false;
+		}
+		return true;
+	}
+	void CullSpheres(const Frustum& frustum, const BoundingSphere* spheres, size_t count, std::vector<unsigned int>& visible)
+	{
+		visible.clear();
+		size_t i = 0;
+		float minDist[4];
+		for (; i + 4 <= count; i += 4)
+		{
+			//x,y,z,radius of 4 spheres -> one register per component
+			simd::f4 cx = simd::Load(&spheres[i + 0].center.x);
+			simd::f4 cy = simd::Load(&spheres[i + 1].center.x);
+			simd::f4 cz = simd::Load(&spheres[i + 2].center.x);
+			simd::f4 r = simd::Load(&spheres[i + 3].center.x);
+			simd::Transpose(cx, cy, cz, r);
+			//Smallest signed distance + radius over all planes. Visible if >= 0
+			simd::f4 d = simd::Splat(INFINITY);
+			for (int p = 0; p < 6; p++)
+			{
+				const Plane& plane = frustum.planes[p];
+				simd::f4 dist = simd::MulAdd(cx, simd::Splat(plane.normal.x), simd::Add(r, simd::Splat(plane.distance)));
+				dist = simd::MulAdd(cy, simd::Splat(plane.normal.y), dist);
+				dist = simd::MulAdd(cz, simd::Splat(plane.normal.z), dist);
+				d = simd::Min(d, dist);
+			}
+			simd::Store(minDist, d);
+			for (int k = 0; k < 4; k++)
+			{
+				if (minDist[k] >= 0)
+					visible.push_back(i + k);
+			}
+		}
+		for (; i < count; i++)
+		{
+			if (IsVisible(frustum, spheres[i]))
+				visible.push_back(i);
+		}
+	}
+	void CullAABBs(const Frustum& frustum, const AABB* boxes, size_t count, std::vector<unsigned int>& visible)
+	{
+		visible.clear();
+		//Per plane |normal|, for the projected box radius
+		ew::Vec3 absNormals[6];
+		for (int p = 0; p < 6; p++)
+		{
+			const ew::Vec3& n = frustum.planes[p].normal;
+			absNormals[p] = ew::Vec3(fabsf(n.x), fabsf(n.y), fabsf(n.z));
+		}
+		size_t i = 0;
+		float c[3][4], e[3][4], minDist[4];
+		for (; i + 4 <= count; i += 4)
+		{
+			for (int k = 0; k < 4; k++)
+			{
+				ew::Vec3 center = boxes[i + k].center();
+				ew::Vec3 extents = boxes[i + k].extents();
+				c[0][k] = center.x; c[1][k] = center.y; c[2][k] = center.z;
+				e[0][k] = extents.x; e[1][k] = extents.y; e[2][k] = extents.z;
+			}
+			simd::f4 cx = simd::Load(c[0]), cy = simd::Load(c[1]), cz = simd::Load(c[2]);
+			simd::f4 ex = simd::Load(e[0]), ey = simd::Load(e[1]), ez = simd::Load(e[2]);
+			simd::f4 d = simd::Splat(INFINITY);
+			for (int p = 0; p < 6; p++)
+			{
+				const Plane& plane = frustum.planes[p];
+				//Signed distance of the center + projected extents
+				simd::f4 dist = simd::MulAdd(cx, simd::Splat(plane.normal.x), simd::Splat(plane.distance));
+				dist = simd::MulAdd(cy, simd::Splat(plane.normal.y), dist);
+				dist = simd::MulAdd(cz, simd::Splat(plane.normal.z), dist);
+				dist = simd::MulAdd(ex, simd::Splat(absNormals[p].x), dist);
+				dist = simd::MulAdd(ey, simd::Splat(absNormals[p].y), dist);
+				dist = simd::MulAdd(ez, simd::Splat(absNormals[p].z), dist);
+				d = simd::Min(d, dist);
+			}
+			simd::Store(minDist, d);
+			for (int k = 0; k < 4; k++)
+			{
+				if (minDist[k] >= 0)
+					visible.push_back(i + k);
+			}
+		}
+		for (; i < count; i++)
+		{
+			if (IsVisible(frustum, boxes[i]))
+				visible.push_back(i);
+		}
+	}
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <vector>
+#include "ewMath/ewMath.h"
+
+namespace ew {
+	//Points p where Dot(normal, p) + distance >= 0 are on the inside
+	struct Plane {
+		ew::Vec3 normal;
+		float distance;
+	};
+
+	struct Frustum {
+		Plane planes[6]; //Left, right, bottom, top, near, far
+	};
+
+	struct AABB {
+		ew::Vec3 min;
+		ew::Vec3 max;
+		inline ew::Vec3 center()const { return (min + max) * 0.5f; }
+		inline ew::Vec3 extents()const { return (max - min) * 0.5f; }
+	};
+
+	struct BoundingSphere {
+		ew::Vec3 center;
+		float radius;
+	};
+
+	//Planes of a view projection matrix (Gribb/Hartmann), normalized. In world space when given projection * view
+	Frustum ExtractFrustum(const ew::Mat4& viewProjection);
+
+	//World space bounds of local bounds transformed by a model matrix
+	AABB TransformAABB(const AABB& box, const ew::Mat4& m);
+	BoundingSphere TransformSphere(const BoundingSphere& sphere, const ew::Mat4& m);
+
+	bool IsVisible(const Frustum& frustum, const AABB& box);
+	bool IsVisible(const Frustum& frustum, const BoundingSphere& sphere);
+
+	/// <summary>
+	/// Tests count bounds against the frustum, 4 per iteration.
+	/// </summary>
+	/// <param name="visible">Cleared, then filled with the indices of bounds that are at least partially inside</param>
+	void CullSpheres(const Frustum& frustum, const BoundingSphere* spheres, size_t count, std::vector<unsigned int>& visible);
+	void CullAABBs(const Frustum& frustum, const AABB* boxes, size_t count, std::vector<unsigned int>& visible);
+}
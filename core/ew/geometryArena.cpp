@@ -0,0 +1,189 @@
+#include "geometryArena.h"
+#include "external/glad.h"
+#include "vertexPacking.h"
+#include <algorithm>
+
+namespace ew {
+	size_t RangeAllocator::allocate(size_t count)
+	{
+		if (count == 0)
+			return 0;
+		for (auto it = m_free.begin(); it != m_free.end(); ++it)
+		{
+			if (it->second < count)
+				continue;
+			const size_t offset = it->first;
+			const size_t remaining = it->second - count;
+			m_free.erase(it);
+			if (remaining > 0)
+				m_free[offset + count] = remaining;
+			return offset;
+		}
+		return INVALID;
+	}
+
+	void RangeAllocator::free(size_t offset, size_t count)
+	{
+		if (count == 0)
+			return;
+		auto next = m_free.lower_bound(offset);
+		//Merge with the free range right after
+		if (next != m_free.end() && next->first == offset + count) {
+			count += next->second;
+			next = m_free.erase(next);
+		}
+		//and the one right before
+		if (next != m_free.begin()) {
+			auto prev = std::prev(next);
+			if (prev->first + prev->second == offset) {
+				prev->second += count;
+				return;
+			}
+		}
+		m_free[offset] = count;
+	}
+
+	void RangeAllocator::grow(size_t newCapacity)
+	{
+		if (newCapacity <= m_capacity)
+			return;
+		const size_t oldCapacity = m_capacity;
+		m_capacity = newCapacity;
+		free(oldCapacity, newCapacity - oldCapacity);
+	}
+
+	//Replaces buffer with a bigger one holding the same first oldBytes
+	static void resizeBuffer(GLenum target, unsigned int& buffer, size_t oldBytes, size_t newBytes) {
+		unsigned int resized;
+		glGenBuffers(1, &resized);
+		glBindBuffer(target, resized);
+		glBufferData(target, newBytes, NULL, GL_STATIC_DRAW);
+		if (oldBytes > 0) {
+			glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+			glCopyBufferSubData(GL_COPY_READ_BUFFER, target, 0, 0, oldBytes);
+			glBindBuffer(GL_COPY_READ_BUFFER, 0);
+		}
+		glDeleteBuffers(1, &buffer);
+		buffer = resized;
+	}
+
+	GeometryArena::GeometryArena(size_t vertexCapacity, size_t indexCapacity, VertexFormat format)
+		:m_format(format)
+	{
+		glGenVertexArrays(1, &m_vao);
+		glGenBuffers(1, &m_vbo);
+		glGenBuffers(1, &m_ebo);
+		glBindVertexArray(m_vao);
+		glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+		glBufferData(GL_ARRAY_BUFFER, vertexSize() * vertexCapacity, NULL, GL_STATIC_DRAW);
+		setVertexAttributes(m_format);
+		glEnableVertexAttribArray(0);
+		glEnableVertexAttribArray(1);
+		glEnableVertexAttribArray(2);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * indexCapacity, NULL, GL_STATIC_DRAW);
+		glBindVertexArray(0);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		m_vertexSpace.grow(vertexCapacity);
+		m_indexSpace.grow(indexCapacity);
+	}
+
+	GeometryArena::~GeometryArena()
+	{
+		glDeleteVertexArrays(1, &m_vao);
+		glDeleteBuffers(1, &m_vbo);
+		glDeleteBuffers(1, &m_ebo);
+	}
+
+	size_t GeometryArena::vertexSize() const
+	{
+		return m_format == VertexFormat::PACKED ? sizeof(PackedVertex) : sizeof(Vertex);
+	}
+
+	void GeometryArena::growVertices(size_t minCapacity)
+	{
+		const size_t oldCapacity = m_vertexSpace.getCapacity();
+		const size_t newCapacity = std::max(oldCapacity * 2, minCapacity);
+		glBindVertexArray(m_vao);
+		resizeBuffer(GL_ARRAY_BUFFER, m_vbo, oldCapacity * vertexSize(), newCapacity * vertexSize());
+		//Attribute pointers capture the buffer bound when they are set
+		setVertexAttributes(m_format);
+		glBindVertexArray(0);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		m_vertexSpace.grow(newCapacity);
+	}
+
+	void GeometryArena::growIndices(size_t minCapacity)
+	{
+		const size_t oldCapacity = m_indexSpace.getCapacity();
+		const size_t newCapacity = std::max(oldCapacity * 2, minCapacity);
+		//Binding the element buffer with the VAO bound attaches it
+		glBindVertexArray(m_vao);
+		resizeBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo, oldCapacity * sizeof(unsigned int), newCapacity * sizeof(unsigned int));
+		glBindVertexArray(0);
+		m_indexSpace.grow(newCapacity);
+	}
+
+	int GeometryArena::add(const Vertex* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount)
+	{
+		ArenaRange range;
+		range.vertexCount = vertexCount;
+		range.indexCount = indexCount;
+		range.firstVertex = m_vertexSpace.allocate(vertexCount);
+		if (range.firstVertex == RangeAllocator::INVALID) {
+			growVertices(m_vertexSpace.getCapacity() + vertexCount);
+			range.firstVertex = m_vertexSpace.allocate(vertexCount);
+		}
+		range.firstIndex = m_indexSpace.allocate(indexCount);
+		if (range.firstIndex == RangeAllocator::INVALID) {
+			growIndices(m_indexSpace.getCapacity() + indexCount);
+			range.firstIndex = m_indexSpace.allocate(indexCount);
+		}
+
+		glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+		if (m_format == VertexFormat::PACKED) {
+			const PackingBounds bounds = ComputePackingBounds(vertices, vertexCount);
+			std::vector<PackedVertex> packed(vertexCount);
+			PackVertices(vertices, vertexCount, bounds, packed.data());
+			glBufferSubData(GL_ARRAY_BUFFER, sizeof(PackedVertex) * range.firstVertex, sizeof(PackedVertex) * vertexCount, packed.data());
+			range.dequantize = bounds.dequantizeMatrix();
+		}
+		else {
+			glBufferSubData(GL_ARRAY_BUFFER, sizeof(Vertex) * range.firstVertex, sizeof(Vertex) * vertexCount, vertices);
+			range.dequantize = ew::IdentityMatrix();
+		}
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		//GL_ELEMENT_ARRAY_BUFFER binding belongs to the VAO, use the copy target so whatever VAO is bound isn't touched
+		glBindBuffer(GL_COPY_WRITE_BUFFER, m_ebo);
+		glBufferSubData(GL_COPY_WRITE_BUFFER, sizeof(unsigned int) * range.firstIndex, sizeof(unsigned int) * indexCount, indices);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+		if (!m_freeHandles.empty()) {
+			const int handle = m_freeHandles.back();
+			m_freeHandles.pop_back();
+			m_meshes[handle] = range;
+			return handle;
+		}
+		m_meshes.push_back(range);
+		return (int)m_meshes.size() - 1;
+	}
+
+	int GeometryArena::add(const MeshData& meshData)
+	{
+		return add(meshData.vertices.data(), meshData.vertices.size(), meshData.indices.data(), meshData.indices.size());
+	}
+
+	void GeometryArena::remove(int mesh)
+	{
+		ArenaRange& range = m_meshes[mesh];
+		m_vertexSpace.free(range.firstVertex, range.vertexCount);
+		m_indexSpace.free(range.firstIndex, range.indexCount);
+		range.vertexCount = range.indexCount = 0;
+		m_freeHandles.push_back(mesh);
+	}
+
+	void GeometryArena::bind() const
+	{
+		glBindVertexArray(m_vao);
+	}
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <map>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+#include "mesh.h"
+
+namespace ew {
+	//First fit allocator of ranges in [0, capacity). Freed ranges merge with free neighbours
+	class RangeAllocator {
+	public:
+		static const size_t INVALID = SIZE_MAX;
+		//Returns the offset of count free elements, or INVALID if no free range is big enough
+		size_t allocate(size_t count);
+		void free(size_t offset, size_t count);
+		//Adds [capacity, newCapacity) as free space
+		void grow(size_t newCapacity);
+		inline size_t getCapacity()const { return m_capacity; }
+	private:
+		std::map<size_t, size_t> m_free; //Offset -> count
+		size_t m_capacity = 0;
+	};
+
+	//Where one mesh lives in a GeometryArena. Indices are relative to firstVertex
+	struct ArenaRange {
+		size_t firstVertex;
+		size_t vertexCount;
+		size_t firstIndex;
+		size_t indexCount;
+		ew::Mat4 dequantize; //Identity unless the arena is PACKED
+	};
+
+	/// <summary>
+	/// One vertex buffer, index buffer and VAO shared by many meshes of the same vertex format, so they can all be
+	/// drawn without rebinding, e.g. by a DrawList in a single multi draw. Indices are 32 bit so every draw shares one type.
+	/// Buffers start at the given capacity and double when a mesh doesn't fit.
+	/// </summary>
+	class GeometryArena {
+	public:
+		static const int INVALID = -1;
+		GeometryArena(size_t vertexCapacity = 65536, size_t indexCapacity = 3 * 65536, VertexFormat format = VertexFormat::FLOAT);
+		~GeometryArena();
+		GeometryArena(const GeometryArena&) = delete;
+		GeometryArena& operator=(const GeometryArena&) = delete;
+		//Copies a mesh into the arena. Returns its handle for get, remove and DrawList::add
+		int add(const Vertex* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount);
+		int add(const MeshData& meshData);
+		//Frees the mesh's ranges for later adds. Its handle may be reused
+		void remove(int mesh);
+		inline const ArenaRange& get(int mesh)const { return m_meshes[mesh]; }
+		//Binds the shared VAO, with the element buffer attached
+		void bind()const;
+		inline VertexFormat getVertexFormat()const { return m_format; }
+		inline size_t getVertexCapacity()const { return m_vertexSpace.getCapacity(); }
+		inline size_t getIndexCapacity()const { return m_indexSpace.getCapacity(); }
+	private:
+		void growVertices(size_t minCapacity);
+		void growIndices(size_t minCapacity);
+		size_t vertexSize()const;
+		VertexFormat m_format;
+		unsigned int m_vao = 0;
+		unsigned int m_vbo = 0;
+		unsigned int m_ebo = 0;
+		RangeAllocator m_vertexSpace;
+		RangeAllocator m_indexSpace;
+		std::vector<ArenaRange> m_meshes;
+		std::vector<int> m_freeHandles;
+	};
+}
@@ -0,0 +1,107 @@
+#include "indexBuffer.h"
+#include "external/glad.h"
+#include <algorithm>
+#include <string.h>
+#include <stdint.h>
+
+namespace ew {
+	static const size_t MAX_16BIT_VERTICES = 65536;
+
+	static IndexBufferLayout build32(const unsigned int* indices, size_t count, std::vector<unsigned char>& out) {
+		out.resize(count * sizeof(unsigned int));
+		if (count > 0)
+			memcpy(out.data(), indices, count * sizeof(unsigned int));
+		return indexLayout32(count);
+	}
+
+	IndexBufferLayout indexLayout32(size_t count)
+	{
+		IndexBufferLayout layout;
+		layout.type = IndexType::UINT32;
+		layout.chunks.push_back({ 0, count, 0 });
+		return layout;
+	}
+
+	IndexBufferLayout buildIndexBuffer(const unsigned int* indices, size_t count, size_t numVertices, std::vector<unsigned char>& out)
+	{
+		IndexBufferLayout layout;
+		layout.type = IndexType::UINT16;
+
+		if (numVertices <= MAX_16BIT_VERTICES) {
+			out.resize(count * sizeof(unsigned short));
+			unsigned short* dst = (unsigned short*)out.data();
+			for (size_t i = 0; i < count; i++)
+				dst[i] = (unsigned short)indices[i];
+			layout.chunks.push_back({ 0, count, 0 });
+			return layout;
+		}
+
+		//Greedily grow each chunk a triangle at a time while its vertex range still fits in 16 bits
+		size_t chunkStart = 0;
+		unsigned int chunkMin = UINT32_MAX, chunkMax = 0;
+		for (size_t i = 0; i + 3 <= count; i += 3)
+		{
+			const unsigned int triMin = std::min(indices[i], std::min(indices[i + 1], indices[i + 2]));
+			const unsigned int triMax = std::max(indices[i], std::max(indices[i + 1], indices[i + 2]));
+			if (triMax - triMin >= MAX_16BIT_VERTICES)
+				return build32(indices, count, out);
+			const unsigned int newMin = std::min(chunkMin, triMin);
+			const unsigned int newMax = std::max(chunkMax, triMax);
+			if (newMax - newMin >= MAX_16BIT_VERTICES) {
+				layout.chunks.push_back({ chunkStart, i - chunkStart, (int)chunkMin });
+				if (layout.chunks.size() >= MAX_INDEX_CHUNKS)
+					return build32(indices, count, out);
+				chunkStart = i;
+				chunkMin = triMin;
+				chunkMax = triMax;
+			}
+			else {
+				chunkMin = newMin;
+				chunkMax = newMax;
+			}
+		}
+		//Trailing indices that don't make a full triangle are dropped, GL would ignore them anyway
+		const size_t usedCount = count - count % 3;
+		if (usedCount > chunkStart)
+			layout.chunks.push_back({ chunkStart, usedCount - chunkStart, (int)chunkMin });
+
+		out.resize(usedCount * sizeof(unsigned short));
+		unsigned short* dst = (unsigned short*)out.data();
+		for (const IndexChunk& chunk : layout.chunks)
+		{
+			for (size_t i = chunk.firstIndex; i < chunk.firstIndex + chunk.count; i++)
+				dst[i] = (unsigned short)(indices[i] - chunk.baseVertex);
+		}
+		return layout;
+	}
+
+	void drawIndexed(unsigned int mode, const IndexBufferLayout& layout, int instanceCount)
+	{
+		for (const IndexChunk& chunk : layout.chunks)
+			drawIndexedRange(mode, layout, chunk.firstIndex, chunk.count, instanceCount);
+	}
+
+	void drawIndexedRange(unsigned int mode, const IndexBufferLayout& layout, size_t firstIndex, size_t count, int instanceCount)
+	{
+		if (instanceCount <= 0)
+			return;
+		const size_t indexSize = layout.indexSize();
+		const GLenum type = layout.type == IndexType::UINT16 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+		const size_t end = firstIndex + count;
+		//Chunks are in index order, draw the part of the range each one covers
+		for (const IndexChunk& chunk : layout.chunks)
+		{
+			const size_t first = std::max(firstIndex, chunk.firstIndex);
+			const size_t last = std::min(end, chunk.firstIndex + chunk.count);
+			if (first >= last)
+				continue;
+			const void* offset = (const void*)(layout.byteOffset + first * indexSize);
+			if (instanceCount > 1)
+				glDrawElementsInstancedBaseVertex(mode, (GLsizei)(last - first), type, offset, instanceCount, chunk.baseVertex);
+			else if (chunk.baseVertex == 0)
+				glDrawElements(mode, (GLsizei)(last - first), type, offset);
+			else
+				glDrawElementsBaseVertex(mode, (GLsizei)(last - first), type, offset, chunk.baseVertex);
+		}
+	}
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <vector>
+#include <stddef.h>
+
+namespace ew {
+	//Range of an element buffer drawn with one call. Indices in the range are relative to baseVertex
+	struct IndexChunk {
+		size_t firstIndex;
+		size_t count;
+		int baseVertex;
+	};
+
+	enum class IndexType {
+		UINT16 = 0,
+		UINT32 = 1
+	};
+
+	//How indices were laid out in an element buffer, needed to draw it
+	struct IndexBufferLayout {
+		IndexType type = IndexType::UINT32;
+		std::vector<IndexChunk> chunks;
+		size_t byteOffset = 0; //Where index 0 is in the element buffer, for indices suballocated from a shared buffer
+
+		inline size_t indexSize()const { return type == IndexType::UINT16 ? 2 : 4; }
+	};
+
+	//Meshes that need more 16 bit chunks than this are kept at 32 bit, so they still draw in a few calls
+	const size_t MAX_INDEX_CHUNKS = 16;
+
+	/// <summary>
+	/// Picks the smallest index type for a triangle list. Meshes with at most 65536 vertices get 16 bit indices.
+	/// Larger ones are split into chunks whose vertices span at most 65536, each drawn with its own base vertex.
+	/// Falls back to 32 bit when that isn't possible.
+	/// </summary>
+	/// <param name="out">Resized and filled with the bytes to upload</param>
+	IndexBufferLayout buildIndexBuffer(const unsigned int* indices, size_t count, size_t numVertices, std::vector<unsigned char>& out);
+
+	//32 bit layout with a single chunk, for indices written straight into GPU memory
+	IndexBufferLayout indexLayout32(size_t count);
+
+	//Issues one glDrawElementsBaseVertex per chunk. The VAO with the element buffer must be bound
+	void drawIndexed(unsigned int mode, const IndexBufferLayout& layout, int instanceCount = 1);
+	//Draws count indices starting at firstIndex (in original index order), e.g. one LodLevel.
+	//instanceCount above 1 uses the instanced draw calls, still one per chunk
+	void drawIndexedRange(unsigned int mode, const IndexBufferLayout& layout, size_t firstIndex, size_t count, int instanceCount = 1);
+}
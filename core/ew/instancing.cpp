@@ -0,0 +1,54 @@
+#include "instancing.h"
+#include "external/glad.h"
+
+namespace ew {
+	InstanceBuffer::~InstanceBuffer()
+	{
+		if (m_vbo)
+			glDeleteBuffers(1, &m_vbo);
+	}
+	void InstanceBuffer::upload(const InstanceData* instances, size_t count)
+	{
+		if (!m_vbo)
+			glGenBuffers(1, &m_vbo);
+		glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+		if (count > m_capacity) {
+			glBufferData(GL_ARRAY_BUFFER, sizeof(InstanceData) * count, instances, GL_DYNAMIC_DRAW);
+			m_capacity = count;
+		}
+		else if (count > 0) {
+			glBufferData(GL_ARRAY_BUFFER, sizeof(InstanceData) * m_capacity, NULL, GL_DYNAMIC_DRAW);
+			glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(InstanceData) * count, instances);
+		}
+		m_count = count;
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+	void InstanceBuffer::bindAttributes()
+	{
+		if (!m_vbo)
+			glGenBuffers(1, &m_vbo);
+		setInstanceAttributes();
+		glBindVertexBuffer(INSTANCE_BINDING, m_vbo, 0, sizeof(InstanceData));
+	}
+	void setInstanceAttributes()
+	{
+		unsigned int location = INSTANCE_ATTRIBUTE_LOCATION;
+		//Matrices take one attribute per column
+		for (int i = 0; i < 4; i++, location++)
+		{
+			glEnableVertexAttribArray(location);
+			glVertexAttribFormat(location, 4, GL_FLOAT, GL_FALSE, offsetof(InstanceData, model) + sizeof(float) * 4 * i);
+			glVertexAttribBinding(location, INSTANCE_BINDING);
+		}
+		for (int i = 0; i < 3; i++, location++)
+		{
+			glEnableVertexAttribArray(location);
+			glVertexAttribFormat(location, 3, GL_FLOAT, GL_FALSE, offsetof(InstanceData, normal) + sizeof(float) * 3 * i);
+			glVertexAttribBinding(location, INSTANCE_BINDING);
+		}
+		glEnableVertexAttribArray(location);
+		glVertexAttribFormat(location, 4, GL_FLOAT, GL_FALSE, offsetof(InstanceData, color));
+		glVertexAttribBinding(location, INSTANCE_BINDING);
+		glVertexBindingDivisor(INSTANCE_BINDING, 1);
+	}
+}
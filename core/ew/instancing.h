@@ -0,0 +1,47 @@
+#pragma once
+#include <stddef.h>
+#include "ewMath/ewMath.h"
+
+namespace ew {
+	//Per instance vertex attributes. Shaders read them from INSTANCE_ATTRIBUTE_LOCATION onward:
+	//3-6 model matrix columns, 7-9 normal matrix columns, 10 color
+	struct InstanceData {
+		ew::Mat4 model;
+		ew::Mat3 normal; //Inverse transpose of model
+		ew::Vec4 color;
+
+		InstanceData() = default;
+		InstanceData(const ew::Mat4& model, const ew::Vec4& color = ew::Vec4(1.0f))
+			:model(model), normal(NormalMatrix(model)), color(color) {}
+	};
+
+	const unsigned int INSTANCE_ATTRIBUTE_LOCATION = 3;
+	const unsigned int INSTANCE_ATTRIBUTE_COUNT = 8;
+	//Vertex buffer binding point the instance attributes read from, so the buffer behind them can be swapped with glBindVertexBuffer
+	const unsigned int INSTANCE_BINDING = 3;
+
+	//Enables the instance attributes of the bound VAO and points them at INSTANCE_BINDING with divisor 1
+	void setInstanceAttributes();
+
+	/// <summary>
+	/// GPU array of InstanceData that meshes read as divisor 1 vertex attributes.
+	/// Attach it to a mesh once, then upload new instances whenever they change.
+	/// </summary>
+	class InstanceBuffer {
+	public:
+		InstanceBuffer() {};
+		~InstanceBuffer();
+		InstanceBuffer(const InstanceBuffer&) = delete;
+		InstanceBuffer& operator=(const InstanceBuffer&) = delete;
+		//Replaces the contents. Reuses the allocation when it is big enough, orphaning it so the GPU never stalls on the old data
+		void upload(const InstanceData* instances, size_t count);
+		//Points the instance attributes of the currently bound VAO at this buffer
+		void bindAttributes();
+		inline size_t getCount()const { return m_count; }
+		inline unsigned int getBuffer()const { return m_vbo; }
+	private:
+		unsigned int m_vbo = 0;
+		size_t m_count = 0;
+		size_t m_capacity = 0;
+	};
+}
@@ -0,0 +1,55 @@
+#include "lod.h"
+#include "meshSimplifier.h"
+#include "meshOptimizer.h"
+
+namespace ew {
+	std::vector<LodLevel> BuildLodChain(const unsigned int* indices, size_t indexCount, const float* positions, size_t positionStride, size_t vertexCount,
+		std::vector<unsigned int>& lodIndices, int maxLevels, float ratio, float maxError)
+	{
+		std::vector<LodLevel> levels;
+		lodIndices.assign(indices, indices + indexCount);
+		levels.push_back({ 0, indexCount, 0.0f });
+
+		std::vector<unsigned int> simplified(indexCount);
+		for (int level = 1; level < maxLevels; level++)
+		{
+			const LodLevel& previous = levels.back();
+			//Simplify from the previous level so each step only does the new work. Errors add up across levels
+			const size_t target = (size_t)(previous.indexCount / 3 * ratio) * 3;
+			float error = 0.0f;
+			const size_t count = SimplifyMesh(simplified.data(), lodIndices.data() + previous.firstIndex, previous.indexCount,
+				positions, positionStride, vertexCount, target, maxError - previous.error, &error);
+			//Stop once a level no longer saves much
+			if (count == 0 || count > previous.indexCount * (1.0f + ratio) * 0.5f)
+				break;
+			OptimizeVertexCache(simplified.data(), count, vertexCount);
+			levels.push_back({ lodIndices.size(), count, previous.error + error });
+			lodIndices.insert(lodIndices.end(), simplified.begin(), simplified.begin() + count);
+		}
+		return levels;
+	}
+
+	float ProjectedRadius(const Camera& camera, const ew::Vec3& center, float radius, float screenHeight)
+	{
+		if (camera.orthographic)
+			return radius / camera.orthoHeight * screenHeight;
+		const float distance = ew::Magnitude(center - camera.position);
+		//Inside the sphere, treat it as filling the screen
+		if (distance <= radius)
+			return screenHeight;
+		const float halfFovTan = tanf(ew::Radians(camera.fov) * 0.5f);
+		return radius / (distance * halfFovTan) * screenHeight * 0.5f;
+	}
+
+	size_t SelectLod(const std::vector<LodLevel>& levels, float projectedRadius, float maxScreenError)
+	{
+		size_t selected = 0;
+		for (size_t i = 1; i < levels.size(); i++)
+		{
+			if (levels[i].error * projectedRadius > maxScreenError)
+				break;
+			selected = i;
+		}
+		return selected;
+	}
+}
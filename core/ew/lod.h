@@ -0,0 +1,32 @@
+#pragma once
+#include <vector>
+#include <stddef.h>
+#include "camera.h"
+
+namespace ew {
+	//One level of detail: a range of a shared index buffer
+	struct LodLevel {
+		size_t firstIndex;
+		size_t indexCount;
+		float error; //Geometric error relative to the mesh radius, 0 for the original
+	};
+
+	/// <summary>
+	/// Simplifies a mesh into up to maxLevels levels, each targeting ratio times the triangles of the one before.
+	/// Every level indexes the same vertices, so they can live in one vertex buffer.
+	/// </summary>
+	/// <param name="lodIndices">Cleared, then filled with every level's indices back to back, level 0 first</param>
+	/// <param name="maxError">Levels stop once simplifying further would exceed this error</param>
+	/// <returns>The levels, finest first. Always contains at least level 0</returns>
+	std::vector<LodLevel> BuildLodChain(const unsigned int* indices, size_t indexCount, const float* positions, size_t positionStride, size_t vertexCount,
+		std::vector<unsigned int>& lodIndices, int maxLevels = 4, float ratio = 0.5f, float maxError = 0.05f);
+
+	//Radius in pixels of a world space sphere as seen by camera, for a viewport screenHeight pixels tall
+	float ProjectedRadius(const Camera& camera, const ew::Vec3& center, float radius, float screenHeight);
+
+	/// <summary>
+	/// Coarsest level whose error, projected to the screen, stays under maxScreenError pixels.
+	/// </summary>
+	/// <param name="projectedRadius">ProjectedRadius of the mesh's bounding sphere</param>
+	size_t SelectLod(const std::vector<LodLevel>& levels, float projectedRadius, float maxScreenError = 1.0f);
+}
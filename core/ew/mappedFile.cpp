@@ -0,0 +1,109 @@
+#include "mappedFile.h"
+#include <stdio.h>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ew {
+	MappedFile::~MappedFile()
+	{
+		close();
+	}
+
+#ifdef _WIN32
+	bool MappedFile::open(const char* path)
+	{
+		close();
+		HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+		if (file == INVALID_HANDLE_VALUE) {
+			printf("Failed to open %s\n", path);
+			return false;
+		}
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+			printf("Failed to map %s: empty file\n", path);
+			CloseHandle(file);
+			return false;
+		}
+		HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+		const void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+		if (!view) {
+			printf("Failed to map %s\n", path);
+			if (mapping)
+				CloseHandle(mapping);
+			CloseHandle(file);
+			return false;
+		}
+		m_file = file;
+		m_mapping = mapping;
+		m_data = (const unsigned char*)view;
+		m_size = (size_t)size.QuadPart;
+		return true;
+	}
+
+	void MappedFile::close()
+	{
+		if (m_data)
+			UnmapViewOfFile(m_data);
+		if (m_mapping)
+			CloseHandle((HANDLE)m_mapping);
+		if (m_file)
+			CloseHandle((HANDLE)m_file);
+		m_data = nullptr;
+		m_size = 0;
+		m_mapping = nullptr;
+		m_file = nullptr;
+	}
+#else
+	bool MappedFile::open(const char* path)
+	{
+		close();
+		const int file = ::open(path, O_RDONLY);
+		if (file < 0) {
+			printf("Failed to open %s\n", path);
+			return false;
+		}
+		struct stat info;
+		if (fstat(file, &info) != 0 || info.st_size == 0) {
+			printf("Failed to map %s: empty file\n", path);
+			::close(file);
+			return false;
+		}
+		void* view = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+		//The mapping keeps its own reference to the file
+		::close(file);
+		if (view == MAP_FAILED) {
+			printf("Failed to map %s\n", path);
+			return false;
+		}
+		m_data = (const unsigned char*)view;
+		m_size = (size_t)info.st_size;
+		return true;
+	}
+
+	void MappedFile::close()
+	{
+		if (m_data)
+			munmap((void*)m_data, m_size);
+		m_data = nullptr;
+		m_size = 0;
+	}
+#endif
+
+	void MappedFile::prefetch()const
+	{
+		//Smallest page size of any platform we run on, larger pages just get touched more than once
+		const size_t PAGE = 4096;
+		volatile unsigned char sink = 0;
+		for (size_t i = 0; i < m_size; i += PAGE)
+			sink += m_data[i];
+		(void)sink;
+	}
+}
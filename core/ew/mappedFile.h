@@ -0,0 +1,31 @@
+#pragma once
+#include <stddef.h>
+
+namespace ew {
+	/// <summary>
+	/// Read only memory mapping of a whole file. Pages are read from disk the first time they are touched,
+	/// so nothing is copied or parsed up front. The mapping lives until close() or destruction.
+	/// </summary>
+	class MappedFile {
+	public:
+		MappedFile() = default;
+		~MappedFile();
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		//Closes any open mapping first. False, with a message printed, if the file can't be opened or mapped
+		bool open(const char* path);
+		void close();
+		inline const unsigned char* data()const { return m_data; }
+		inline size_t size()const { return m_size; }
+		inline bool isOpen()const { return m_data != nullptr; }
+		//Touches every page so the disk reads happen now, on this thread, instead of on whichever thread first uses the data
+		void prefetch()const;
+	private:
+		const unsigned char* m_data = nullptr;
+		size_t m_size = 0;
+#ifdef _WIN32
+		void* m_file = nullptr; //HANDLE
+		void* m_mapping = nullptr; //HANDLE
+#endif
+	};
+}
@@ -5,13 +5,16 @@
 #include "mesh.h"
 #include "ewMath/ewMath.h"
 #include "external/glad.h"
+#include "vertexPacking.h"
+#include <stdio.h>
+#include <string.h>
 
 namespace ew {
-	Mesh::Mesh(const MeshData& meshData)
+	Mesh::Mesh(const MeshData& meshData, VertexFormat format)
 	{
-		load(meshData);
+		load(meshData, format);
 	}
-	void Mesh::load(const MeshData& meshData)
+	void Mesh::initialize()
 	{
 		if (!m_initialized) {
 			glGenVertexArrays(1, &m_vao);
@@ -22,30 +25,69 @@ namespace ew {
 
 			glGenBuffers(1, &m_ebo);
 			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
-			//Position attribute
-			glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const void*)offsetof(Vertex, pos));
-			glEnableVertexAttribArray(0);
 
-			//Normal attribute
-			glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const void*)offsetof(Vertex, normal));
+			m_vertexFormat = VertexFormat::FLOAT;
+			setVertexAttributes(m_vertexFormat);
+			glEnableVertexAttribArray(0);
 			glEnableVertexAttribArray(1);
-
-			//UV attribute
-			glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const void*)(offsetof(Vertex, uv)));
 			glEnableVertexAttribArray(2);
 
 			m_initialized = true;
 		}
+	}
+	void setVertexAttributes(VertexFormat format, size_t baseOffset)
+	{
+		if (format == VertexFormat::PACKED) {
+			//Position attribute, snorm16 in [-1,1] of the mesh bounds
+			glVertexAttribPointer(0, 3, GL_SHORT, GL_TRUE, sizeof(PackedVertex), (const void*)(baseOffset + offsetof(PackedVertex, pos)));
+			//Normal attribute, snorm 10:10:10
+			glVertexAttribPointer(1, 4, GL_INT_2_10_10_10_REV, GL_TRUE, sizeof(PackedVertex), (const void*)(baseOffset + offsetof(PackedVertex, normal)));
+			//UV attribute
+			glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(PackedVertex), (const void*)(baseOffset + offsetof(PackedVertex, uv)));
+			return;
+		}
+		//Position attribute
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const void*)(baseOffset + offsetof(Vertex, pos)));
+
+		//Normal attribute
+		glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const void*)(baseOffset + offsetof(Vertex, normal)));
+
+		//UV attribute
+		glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const void*)(baseOffset + offsetof(Vertex, uv)));
+	}
+	void Mesh::load(const MeshData& meshData, VertexFormat format)
+	{
+		initialize();
 
 		glBindVertexArray(m_vao);
 		glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
 
-		if (meshData.vertices.size() > 0) {
-			glBufferData(GL_ARRAY_BUFFER, sizeof(Vertex) * meshData.vertices.size(), meshData.vertices.data(), GL_STATIC_DRAW);
+		if (format != m_vertexFormat || m_dynamic) {
+			setVertexAttributes(format);
+			m_vertexFormat = format;
+			m_dynamic = false;
+		}
+		if (format == VertexFormat::PACKED) {
+			const PackingBounds bounds = ComputePackingBounds(meshData.vertices.data(), meshData.vertices.size());
+			std::vector<PackedVertex> packed(meshData.vertices.size());
+			PackVertices(meshData.vertices.data(), meshData.vertices.size(), bounds, packed.data());
+			if (packed.size() > 0) {
+				glBufferData(GL_ARRAY_BUFFER, sizeof(PackedVertex) * packed.size(), packed.data(), GL_STATIC_DRAW);
+			}
+			m_dequantize = bounds.dequantizeMatrix();
+		}
+		else {
+			if (meshData.vertices.size() > 0) {
+				glBufferData(GL_ARRAY_BUFFER, sizeof(Vertex) * meshData.vertices.size(), meshData.vertices.data(), GL_STATIC_DRAW);
+			}
+			m_dequantize = ew::IdentityMatrix();
 		}
 		if (meshData.indices.size() > 0) {
-			glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * meshData.indices.size(), meshData.indices.data(), GL_STATIC_DRAW);
+			uploadIndices(meshData.indices.data(), meshData.indices.size(), meshData.vertices.size());
+		}
+		else {
+			m_indexLayout = IndexBufferLayout();
 		}
 		m_numVertices = meshData.vertices.size();
 		m_numIndices = meshData.indices.size();
@@ -54,15 +96,158 @@ namespace ew {
 		glBindBuffer(GL_ARRAY_BUFFER, 0);
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 	}
+	void Mesh::load(const MeshCounts& counts, const std::function<void(Vertex*, unsigned int*)>& fill)
+	{
+		initialize();
+
+		glBindVertexArray(m_vao);
+		glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
+
+		//Mapped loads always write full float vertices
+		if (m_vertexFormat != VertexFormat::FLOAT || m_dynamic) {
+			setVertexAttributes(VertexFormat::FLOAT);
+			m_vertexFormat = VertexFormat::FLOAT;
+			m_dynamic = false;
+		}
+		m_dequantize = ew::IdentityMatrix();
+
+		//Small meshes stage their indices on the CPU so they can be narrowed to 16 bit.
+		//Large ones write 32 bit indices straight into the mapped element buffer.
+		const bool stageIndices = counts.numVertices <= 65536;
+		std::vector<unsigned int> stagedIndices;
+
+		const GLsizeiptr vertexBytes = sizeof(Vertex) * counts.numVertices;
+		const GLsizeiptr indexBytes = sizeof(unsigned int) * counts.numIndices;
+		glBufferData(GL_ARRAY_BUFFER, vertexBytes, NULL, GL_STATIC_DRAW);
+		Vertex* vertices = counts.numVertices > 0 ? (Vertex*)glMapBufferRange(GL_ARRAY_BUFFER, 0, vertexBytes, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT) : NULL;
+		unsigned int* indices = NULL;
+		if (stageIndices) {
+			stagedIndices.resize(counts.numIndices);
+			indices = stagedIndices.data();
+		}
+		else if (counts.numIndices > 0) {
+			glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexBytes, NULL, GL_STATIC_DRAW);
+			indices = (unsigned int*)glMapBufferRange(GL_ELEMENT_ARRAY_BUFFER, 0, indexBytes, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+		}
+
+		bool mapped = (vertices || counts.numVertices == 0) && (indices || counts.numIndices == 0);
+		if (mapped) {
+			fill(vertices, indices);
+		}
+		else {
+			printf("Failed to map mesh buffers\n");
+		}
+		//Unmap can fail if the buffer store was lost (e.g. display mode change), in which case the contents are undefined
+		if (vertices && glUnmapBuffer(GL_ARRAY_BUFFER) == GL_FALSE)
+			mapped = false;
+		if (!stageIndices && indices && glUnmapBuffer(GL_ELEMENT_ARRAY_BUFFER) == GL_FALSE)
+			mapped = false;
+		if (!mapped) {
+			//Fall back to generating on the CPU and uploading a copy
+			MeshData meshData;
+			meshData.vertices.resize(counts.numVertices);
+			meshData.indices.resize(counts.numIndices);
+			fill(meshData.vertices.data(), meshData.indices.data());
+			load(meshData);
+			return;
+		}
+		if (stageIndices && counts.numIndices > 0)
+			uploadIndices(stagedIndices.data(), counts.numIndices, counts.numVertices);
+		else
+			m_indexLayout = indexLayout32(counts.numIndices);
+		m_numVertices = counts.numVertices;
+		m_numIndices = counts.numIndices;
+
+		glBindVertexArray(0);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	}
+	bool Mesh::loadDynamic(RingBuffer& ring, const MeshData& meshData)
+	{
+		return loadDynamic(ring, { meshData.vertices.size(), meshData.indices.size() }, [&](Vertex* vertices, unsigned int* indices) {
+			memcpy(vertices, meshData.vertices.data(), sizeof(Vertex) * meshData.vertices.size());
+			memcpy(indices, meshData.indices.data(), sizeof(unsigned int) * meshData.indices.size());
+		});
+	}
+	bool Mesh::loadDynamic(RingBuffer& ring, const MeshCounts& counts, const std::function<void(Vertex*, unsigned int*)>& fill)
+	{
+		//Vertices and indices share one allocation, with index space reserved at 32 bit, so a full ring uses up nothing
+		//and never leaves a half written mesh. Vertex size is a multiple of 4, which keeps the indices aligned
+		const size_t vertexBytes = sizeof(Vertex) * counts.numVertices;
+		const RingAllocation allocation = ring.allocate(vertexBytes + sizeof(unsigned int) * counts.numIndices, sizeof(Vertex));
+		if (!allocation.data) {
+			//Last frame's ring data is about to be overwritten, so a dynamic mesh draws nothing until it loads again
+			if (m_dynamic) {
+				m_numVertices = 0;
+				m_numIndices = 0;
+				m_indexLayout.chunks.clear();
+			}
+			return false;
+		}
+		initialize();
+
+		std::vector<unsigned int> indices(counts.numIndices);
+		fill((Vertex*)allocation.data, indices.data());
+		std::vector<unsigned char> indexData;
+		m_indexLayout = buildIndexBuffer(indices.data(), indices.size(), counts.numVertices, indexData);
+		memcpy((unsigned char*)allocation.data + vertexBytes, indexData.data(), indexData.size());
+		m_indexLayout.byteOffset = allocation.offset + vertexBytes;
+
+		glBindVertexArray(m_vao);
+		glBindBuffer(GL_ARRAY_BUFFER, ring.getBuffer());
+		setVertexAttributes(VertexFormat::FLOAT, allocation.offset);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ring.getBuffer());
+		glBindVertexArray(0);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+		m_vertexFormat = VertexFormat::FLOAT;
+		m_dequantize = ew::IdentityMatrix();
+		m_numVertices = counts.numVertices;
+		m_numIndices = counts.numIndices;
+		m_dynamic = true;
+		return true;
+	}
+	void Mesh::uploadIndices(const unsigned int* indices, size_t count, size_t numVertices)
+	{
+		std::vector<unsigned char> indexData;
+		m_indexLayout = buildIndexBuffer(indices, count, numVertices, indexData);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexData.size(), indexData.data(), GL_STATIC_DRAW);
+	}
 	void Mesh::draw(ew::DrawMode drawMode) const
 	{
 		glBindVertexArray(m_vao);
 		if (drawMode == DrawMode::TRIANGLES) {
-			glDrawElements(GL_TRIANGLES, m_numIndices, GL_UNSIGNED_INT, NULL);
+			drawIndexed(GL_TRIANGLES, m_indexLayout);
 		}
 		else {
 			glDrawArrays(GL_POINTS, 0, m_numVertices);
 		}
 		
 	}
+	void Mesh::drawRange(size_t firstIndex, size_t indexCount) const
+	{
+		glBindVertexArray(m_vao);
+		drawIndexedRange(GL_TRIANGLES, m_indexLayout, firstIndex, indexCount);
+	}
+	void Mesh::setInstanceBuffer(InstanceBuffer& instances)
+	{
+		initialize();
+		glBindVertexArray(m_vao);
+		instances.bindAttributes();
+		glBindVertexArray(0);
+	}
+	void Mesh::setInstanceBuffer(const RingAllocation& instances)
+	{
+		initialize();
+		glBindVertexArray(m_vao);
+		setInstanceAttributes();
+		glBindVertexBuffer(INSTANCE_BINDING, instances.buffer, instances.offset, sizeof(InstanceData));
+		glBindVertexArray(0);
+	}
+	void Mesh::drawInstanced(int instanceCount) const
+	{
+		glBindVertexArray(m_vao);
+		drawIndexed(GL_TRIANGLES, m_indexLayout, instanceCount);
+	}
 }
\ No newline at end of file
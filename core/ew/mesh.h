@@ -3,7 +3,11 @@
 */
 
 #pragma once
+#include <functional>
 #include "ewMath/ewMath.h"
+#include "indexBuffer.h"
+#include "instancing.h"
+#include "ringBuffer.h"
 
 namespace ew {
 	struct Vertex {
@@ -17,25 +21,73 @@ namespace ew {
 		std::vector<unsigned int> indices;
 	};
 
+	struct MeshCounts {
+		size_t numVertices;
+		size_t numIndices;
+	};
+
+	enum class VertexFormat {
+		FLOAT = 0, //Vertex, 32 bytes
+		PACKED = 1 //PackedVertex, 16 bytes. Positions need getDequantizeMatrix()
+	};
+
 	enum class DrawMode {
 		TRIANGLES = 0,
 		POINTS = 1
 	};
 
+	//Points attributes 0-2 of the bound VAO at the bound GL_ARRAY_BUFFER using the given layout, starting baseOffset bytes in
+	void setVertexAttributes(VertexFormat format, size_t baseOffset = 0);
+
 	class Mesh {
 	public:
 		Mesh() {};
-		Mesh(const MeshData& meshData);
-		void load(const MeshData& meshData);
+		Mesh(const MeshData& meshData, VertexFormat format = VertexFormat::FLOAT);
+		void load(const MeshData& meshData, VertexFormat format = VertexFormat::FLOAT);
+		/// <summary>
+		/// Allocates GPU buffers for counts, maps them and lets fill write vertices and indices straight into them,
+		/// so no CPU side copy of the mesh is needed. fill must only write, the mapping is write only.
+		/// Indices of meshes with at most 65536 vertices go through a CPU array so they can be stored as 16 bit.
+		/// </summary>
+		void load(const MeshCounts& counts, const std::function<void(Vertex* vertices, unsigned int* indices)>& fill);
+		/// <summary>
+		/// Dynamic mode: streams the mesh through this frame's region of ring instead of the mesh's own buffers, for geometry that changes every frame.
+		/// Data only lives until ring reuses the region, so call it every frame the mesh is drawn, after ring.beginFrame().
+		/// Returns false if the region is out of space. A static mesh is left unchanged, a dynamic one draws nothing until it loads again.
+		/// A later load switches back to static buffers.
+		/// </summary>
+		bool loadDynamic(RingBuffer& ring, const MeshData& meshData);
+		//fill writes vertices straight into the persistently mapped ring, indices are staged so they can be narrowed to 16 bit
+		bool loadDynamic(RingBuffer& ring, const MeshCounts& counts, const std::function<void(Vertex* vertices, unsigned int* indices)>& fill);
 		void draw(DrawMode drawMode = DrawMode::TRIANGLES)const;
+		//Draws part of the index buffer, e.g. one LodLevel
+		void drawRange(size_t firstIndex, size_t indexCount)const;
+		//Reads per instance attributes from instances in every later drawInstanced
+		void setInstanceBuffer(InstanceBuffer& instances);
+		//Same, with instances written to a RingBuffer this frame
+		void setInstanceBuffer(const RingAllocation& instances);
+		//Draws the whole mesh instanceCount times in one call per index chunk. Needs setInstanceBuffer and an instanced shader
+		void drawInstanced(int instanceCount)const;
 		inline int getNumVertices()const { return m_numVertices; }
 		inline int getNumIndices()const { return m_numIndices; }
+		inline IndexType getIndexType()const { return m_indexLayout.type; }
+		inline VertexFormat getVertexFormat()const { return m_vertexFormat; }
+		inline bool isDynamic()const { return m_dynamic; }
+		//Maps stored positions to model space. Identity unless PACKED. Apply to positions only (e.g. _Model * this), not normals
+		inline const ew::Mat4& getDequantizeMatrix()const { return m_dequantize; }
 	private:
+		void initialize();
+		//Narrows to 16 bit when possible (see buildIndexBuffer) and uploads to the bound element buffer
+		void uploadIndices(const unsigned int* indices, size_t count, size_t numVertices);
 		bool m_initialized = false;
+		bool m_dynamic = false; //Reading from a RingBuffer, see loadDynamic
 		unsigned int m_vao = 0;
 		unsigned int m_vbo = 0;
 		unsigned int m_ebo = 0;
 		int m_numVertices = 0;
 		int m_numIndices = 0;
+		IndexBufferLayout m_indexLayout; //Index type and draw ranges of m_ebo
+		VertexFormat m_vertexFormat = VertexFormat::FLOAT;
+		ew::Mat4 m_dequantize = ew::IdentityMatrix();
 	};
 }
\ No newline at end of file
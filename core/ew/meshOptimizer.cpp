@@ -0,0 +1,260 @@
+#include "meshOptimizer.h"
+#include <algorithm>
+#include <string.h>
+#include <math.h>
+
+namespace ew {
+	VertexCacheStats AnalyzeVertexCache(const unsigned int* indices, size_t indexCount, size_t vertexCount, unsigned int cacheSize)
+	{
+		//A vertex is in the FIFO if it was inserted less than cacheSize misses ago
+		std::vector<size_t> insertedAt(vertexCount, 0);
+		std::vector<bool> referenced(vertexCount, false);
+		size_t misses = 0;
+		size_t uniqueVertices = 0;
+		for (size_t i = 0; i < indexCount; i++)
+		{
+			const unsigned int v = indices[i];
+			if (!referenced[v]) {
+				referenced[v] = true;
+				uniqueVertices++;
+			}
+			//Timestamps start at cacheSize + 1 so an unseen vertex (0) always misses
+			const size_t now = misses + cacheSize + 1;
+			if (now - insertedAt[v] > cacheSize) {
+				insertedAt[v] = now;
+				misses++;
+			}
+		}
+		const size_t triangleCount = indexCount / 3;
+		VertexCacheStats stats;
+		stats.acmr = triangleCount > 0 ? (float)misses / triangleCount : 0.0f;
+		stats.atvr = uniqueVertices > 0 ? (float)misses / uniqueVertices : 0.0f;
+		return stats;
+	}
+
+	void OptimizeVertexCache(unsigned int* indices, size_t indexCount, size_t vertexCount, unsigned int cacheSize, std::vector<size_t>* clusters)
+	{
+		const size_t triangleCount = indexCount / 3;
+		if (clusters) {
+			clusters->clear();
+			clusters->push_back(0);
+		}
+		if (triangleCount == 0)
+			return;
+
+		//Triangles around each vertex, and how many of them are still to be emitted
+		std::vector<unsigned int> liveTriangles(vertexCount, 0);
+		for (size_t i = 0; i < triangleCount * 3; i++)
+			liveTriangles[indices[i]]++;
+		std::vector<size_t> adjacencyStart(vertexCount + 1, 0);
+		for (size_t v = 0; v < vertexCount; v++)
+			adjacencyStart[v + 1] = adjacencyStart[v] + liveTriangles[v];
+		std::vector<unsigned int> adjacency(triangleCount * 3);
+		{
+			std::vector<size_t> fill(adjacencyStart.begin(), adjacencyStart.end() - 1);
+			for (size_t i = 0; i < triangleCount * 3; i++)
+				adjacency[fill[indices[i]]++] = (unsigned int)(i / 3);
+		}
+
+		std::vector<unsigned int> cacheTime(vertexCount, 0);
+		std::vector<bool> emitted(triangleCount, false);
+		std::vector<unsigned int> deadEndStack;
+		std::vector<unsigned int> candidates;
+		std::vector<unsigned int> output;
+		output.reserve(triangleCount * 3);
+		unsigned int timestamp = cacheSize + 1;
+		size_t cursor = 0; //Lowest vertex that may still have live triangles
+
+		long long fanning = indices[0];
+		while (fanning >= 0)
+		{
+			//Emit every remaining triangle around the fanning vertex
+			candidates.clear();
+			for (size_t a = adjacencyStart[fanning]; a < adjacencyStart[fanning + 1]; a++)
+			{
+				const unsigned int triangle = adjacency[a];
+				if (emitted[triangle])
+					continue;
+				for (int k = 0; k < 3; k++)
+				{
+					const unsigned int v = indices[triangle * 3 + k];
+					output.push_back(v);
+					deadEndStack.push_back(v);
+					candidates.push_back(v);
+					liveTriangles[v]--;
+					if (timestamp - cacheTime[v] > cacheSize)
+						cacheTime[v] = timestamp++;
+				}
+				emitted[triangle] = true;
+			}
+
+			//Next fanning vertex: the one that stays in cache longest after its own triangles are emitted
+			long long next = -1;
+			int bestPriority = -1;
+			for (unsigned int v : candidates)
+			{
+				if (liveTriangles[v] == 0)
+					continue;
+				int priority = 0;
+				if (timestamp - cacheTime[v] + 2 * liveTriangles[v] <= cacheSize)
+					priority = timestamp - cacheTime[v];
+				if (priority > bestPriority) {
+					bestPriority = priority;
+					next = v;
+				}
+			}
+			if (next == -1) {
+				//Dead end. Prefer recently used vertices, then anything left
+				while (!deadEndStack.empty())
+				{
+					const unsigned int v = deadEndStack.back();
+					deadEndStack.pop_back();
+					if (liveTriangles[v] > 0) {
+						next = v;
+						break;
+					}
+				}
+				while (next == -1 && cursor < vertexCount)
+				{
+					if (liveTriangles[cursor] > 0)
+						next = cursor;
+					else
+						cursor++;
+				}
+				if (next != -1 && clusters && timestamp - cacheTime[next] > cacheSize)
+					clusters->push_back(output.size());
+			}
+			fanning = next;
+		}
+		memcpy(indices, output.data(), output.size() * sizeof(unsigned int));
+	}
+
+	void OptimizeOverdraw(unsigned int* indices, size_t indexCount, const float* positions, size_t positionStride, size_t vertexCount,
+		const std::vector<size_t>& clusters, unsigned int cacheSize, float threshold)
+	{
+		const size_t triangleCount = indexCount / 3;
+		if (triangleCount == 0)
+			return;
+		auto position = [&](unsigned int v) {
+			const float* p = (const float*)((const unsigned char*)positions + v * positionStride);
+			return ew::Vec3(p[0], p[1], p[2]);
+		};
+
+		//Split hard clusters wherever the cache has settled below threshold * the mesh average
+		const float targetAcmr = AnalyzeVertexCache(indices, indexCount, vertexCount, cacheSize).acmr * threshold;
+		const size_t MIN_CLUSTER_TRIANGLES = 32;
+		std::vector<size_t> starts;
+		std::vector<unsigned int> cacheTime(vertexCount, 0);
+		unsigned int timestamp = cacheSize + 1;
+		for (size_t c = 0; c < clusters.size(); c++)
+		{
+			const size_t clusterEnd = c + 1 < clusters.size() ? clusters[c + 1] : triangleCount * 3;
+			size_t start = clusters[c];
+			size_t misses = 0;
+			starts.push_back(start);
+			for (size_t i = clusters[c]; i < clusterEnd; i += 3)
+			{
+				for (int k = 0; k < 3; k++)
+				{
+					const unsigned int v = indices[i + k];
+					if (timestamp - cacheTime[v] > cacheSize) {
+						cacheTime[v] = timestamp++;
+						misses++;
+					}
+				}
+				const size_t triangles = (i + 3 - start) / 3;
+				if (triangles >= MIN_CLUSTER_TRIANGLES && i + 3 < clusterEnd && (float)misses / triangles <= targetAcmr) {
+					start = i + 3;
+					misses = 0;
+					timestamp += cacheSize + 1; //Flush
+					starts.push_back(start);
+				}
+			}
+		}
+
+		//Mesh centroid, then each cluster's centroid and area weighted normal
+		ew::Vec3 meshCentroid = ew::Vec3(0.0f);
+		for (size_t i = 0; i < triangleCount * 3; i++)
+			meshCentroid += position(indices[i]);
+		meshCentroid /= (float)(triangleCount * 3);
+
+		struct Cluster {
+			size_t start, end;
+			float sortKey;
+		};
+		std::vector<Cluster> sorted(starts.size());
+		for (size_t c = 0; c < starts.size(); c++)
+		{
+			Cluster& cluster = sorted[c];
+			cluster.start = starts[c];
+			cluster.end = c + 1 < starts.size() ? starts[c + 1] : triangleCount * 3;
+			ew::Vec3 centroid = ew::Vec3(0.0f);
+			ew::Vec3 normal = ew::Vec3(0.0f);
+			for (size_t i = cluster.start; i < cluster.end; i += 3)
+			{
+				const ew::Vec3 a = position(indices[i]), b = position(indices[i + 1]), c = position(indices[i + 2]);
+				centroid += a + b + c;
+				normal += ew::Cross(b - a, c - a);
+			}
+			centroid /= (float)(cluster.end - cluster.start);
+			const float normalLength = ew::Magnitude(normal);
+			//Clusters facing away from the center are likely in front of the rest, so draw them first
+			cluster.sortKey = normalLength > 0 ? ew::Dot(centroid - meshCentroid, normal) / normalLength : 0.0f;
+		}
+		std::stable_sort(sorted.begin(), sorted.end(), [](const Cluster& a, const Cluster& b) { return a.sortKey > b.sortKey; });
+
+		std::vector<unsigned int> output;
+		output.reserve(triangleCount * 3);
+		for (const Cluster& cluster : sorted)
+			output.insert(output.end(), indices + cluster.start, indices + cluster.end);
+		memcpy(indices, output.data(), output.size() * sizeof(unsigned int));
+	}
+
+	size_t OptimizeVertexFetch(void* vertices, size_t vertexSize, unsigned int* indices, size_t indexCount, size_t vertexCount)
+	{
+		const unsigned int UNUSED = 0xFFFFFFFF;
+		std::vector<unsigned int> remap(vertexCount, UNUSED);
+		unsigned int next = 0;
+		for (size_t i = 0; i < indexCount; i++)
+		{
+			unsigned int& newIndex = remap[indices[i]];
+			if (newIndex == UNUSED)
+				newIndex = next++;
+			indices[i] = newIndex;
+		}
+		std::vector<unsigned char> original((unsigned char*)vertices, (unsigned char*)vertices + vertexCount * vertexSize);
+		for (size_t v = 0; v < vertexCount; v++)
+		{
+			if (remap[v] != UNUSED)
+				memcpy((unsigned char*)vertices + remap[v] * vertexSize, original.data() + v * vertexSize, vertexSize);
+		}
+		return next;
+	}
+
+	MeshOptimizeStats OptimizeMesh(void* vertices, size_t vertexSize, size_t positionOffset, size_t& vertexCount,
+		unsigned int* indices, size_t indexCount, const MeshOptimizeOptions& options)
+	{
+		MeshOptimizeStats stats;
+		stats.before = AnalyzeVertexCache(indices, indexCount, vertexCount, options.cacheSize);
+
+		std::vector<size_t> clusters;
+		OptimizeVertexCache(indices, indexCount, vertexCount, options.cacheSize, &clusters);
+		if (options.overdraw) {
+			const float* positions = (const float*)((const unsigned char*)vertices + positionOffset);
+			OptimizeOverdraw(indices, indexCount, positions, vertexSize, vertexCount, clusters, options.cacheSize, options.overdrawThreshold);
+		}
+		vertexCount = OptimizeVertexFetch(vertices, vertexSize, indices, indexCount, vertexCount);
+
+		stats.after = AnalyzeVertexCache(indices, indexCount, vertexCount, options.cacheSize);
+		return stats;
+	}
+
+	MeshOptimizeStats OptimizeMesh(MeshData& mesh, const MeshOptimizeOptions& options)
+	{
+		size_t vertexCount = mesh.vertices.size();
+		MeshOptimizeStats stats = OptimizeMesh(mesh.vertices.data(), sizeof(Vertex), offsetof(Vertex, pos), vertexCount,
+			mesh.indices.data(), mesh.indices.size(), options);
+		mesh.vertices.resize(vertexCount);
+		return stats;
+	}
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <stddef.h>
+#include "mesh.h"
+
+//Index and vertex reordering for indexed triangle lists. None of these change what is drawn, only the order.
+namespace ew {
+	//Post transform vertex cache efficiency of a triangle list, from a FIFO cache simulation
+	struct VertexCacheStats {
+		float acmr; //Average cache miss ratio: vertex shader runs per triangle. 0.5 is ideal for big grids, 3 is the worst
+		float atvr; //Average transform to vertex ratio: vertex shader runs per unique vertex. 1 is ideal
+	};
+	VertexCacheStats AnalyzeVertexCache(const unsigned int* indices, size_t indexCount, size_t vertexCount, unsigned int cacheSize = 16);
+
+	/// <summary>
+	/// Reorders triangles for the post transform vertex cache (Tipsify, Sander et al. 2007).
+	/// </summary>
+	/// <param name="clusters">Optional. Filled with the index offsets where the walk had to jump to an unconnected
+	/// part of the mesh. OptimizeOverdraw uses these as cluster boundaries.</param>
+	void OptimizeVertexCache(unsigned int* indices, size_t indexCount, size_t vertexCount, unsigned int cacheSize = 16, std::vector<size_t>* clusters = nullptr);
+
+	/// <summary>
+	/// Reorders clusters of a cache optimized list so outward facing clusters draw first, which lets early depth
+	/// testing reject more of what is behind them. Clusters are split further wherever that costs less than
+	/// threshold times the current cache miss ratio.
+	/// </summary>
+	/// <param name="positions">First position, 3 floats</param>
+	/// <param name="positionStride">Bytes between positions, usually sizeof the vertex</param>
+	void OptimizeOverdraw(unsigned int* indices, size_t indexCount, const float* positions, size_t positionStride, size_t vertexCount,
+		const std::vector<size_t>& clusters, unsigned int cacheSize = 16, float threshold = 1.05f);
+
+	/// <summary>
+	/// Reorders vertices into the order indices first use them and rewrites indices to match. Unreferenced vertices are dropped.
+	/// </summary>
+	/// <param name="vertices">vertexCount vertices of vertexSize bytes each</param>
+	/// <returns>Number of vertices left</returns>
+	size_t OptimizeVertexFetch(void* vertices, size_t vertexSize, unsigned int* indices, size_t indexCount, size_t vertexCount);
+
+	struct MeshOptimizeOptions {
+		bool overdraw = true;
+		unsigned int cacheSize = 16;
+		float overdrawThreshold = 1.05f;
+	};
+	struct MeshOptimizeStats {
+		VertexCacheStats before;
+		VertexCacheStats after;
+	};
+
+	//All three passes in order. Works on any vertex type with a float xyz position at positionOffset
+	MeshOptimizeStats OptimizeMesh(void* vertices, size_t vertexSize, size_t positionOffset, size_t& vertexCount,
+		unsigned int* indices, size_t indexCount, const MeshOptimizeOptions& options = MeshOptimizeOptions());
+	MeshOptimizeStats OptimizeMesh(MeshData& mesh, const MeshOptimizeOptions& options = MeshOptimizeOptions());
+}
@@ -0,0 +1,237 @@
+#include "meshSimplifier.h"
+#include "ewMath/ewMath.h"
+#include <algorithm>
+#include <unordered_map>
+#include <string.h>
+#include <math.h>
+
+namespace ew {
+	//Symmetric 4x4 matrix of the summed squared distances to a set of planes
+	struct Quadric {
+		double a00, a01, a02, a03;
+		double a11, a12, a13;
+		double a22, a23;
+		double a33;
+	};
+
+	static Quadric planeQuadric(double a, double b, double c, double d, double weight) {
+		return Quadric{
+			a * a * weight, a * b * weight, a * c * weight, a * d * weight,
+			b * b * weight, b * c * weight, b * d * weight,
+			c * c * weight, c * d * weight,
+			d * d * weight
+		};
+	}
+
+	static void addQuadric(Quadric& q, const Quadric& r) {
+		q.a00 += r.a00; q.a01 += r.a01; q.a02 += r.a02; q.a03 += r.a03;
+		q.a11 += r.a11; q.a12 += r.a12; q.a13 += r.a13;
+		q.a22 += r.a22; q.a23 += r.a23;
+		q.a33 += r.a33;
+	}
+
+	//p^T Q p with p = (x, y, z, 1)
+	static double quadricError(const Quadric& q, const ew::Vec3& p) {
+		const double x = p.x, y = p.y, z = p.z;
+		return q.a00 * x * x + 2 * q.a01 * x * y + 2 * q.a02 * x * z + 2 * q.a03 * x
+			+ q.a11 * y * y + 2 * q.a12 * y * z + 2 * q.a13 * y
+			+ q.a22 * z * z + 2 * q.a23 * z
+			+ q.a33;
+	}
+
+	struct Collapse {
+		unsigned int from, to;
+		double error;
+	};
+
+	size_t SimplifyMesh(unsigned int* destination, const unsigned int* indices, size_t indexCount, const float* positions, size_t positionStride,
+		size_t vertexCount, size_t targetIndexCount, float targetError, float* resultError)
+	{
+		auto position = [&](unsigned int v) {
+			const float* p = (const float*)((const unsigned char*)positions + v * positionStride);
+			return ew::Vec3(p[0], p[1], p[2]);
+		};
+
+		std::vector<unsigned int> result(indices, indices + indexCount - indexCount % 3);
+		if (resultError)
+			*resultError = 0.0f;
+
+		//Errors are measured relative to the mesh radius so targetError doesn't depend on units
+		ew::Vec3 min = ew::Vec3(INFINITY), max = ew::Vec3(-INFINITY);
+		for (size_t v = 0; v < vertexCount; v++)
+		{
+			const ew::Vec3 p = position((unsigned int)v);
+			min = ew::Vec3(fminf(min.x, p.x), fminf(min.y, p.y), fminf(min.z, p.z));
+			max = ew::Vec3(fmaxf(max.x, p.x), fmaxf(max.y, p.y), fmaxf(max.z, p.z));
+		}
+		const float radius = vertexCount > 0 ? ew::Magnitude(max - min) * 0.5f : 0.0f;
+		if (radius <= 0 || result.size() <= targetIndexCount) {
+			std::copy(result.begin(), result.end(), destination);
+			return result.size();
+		}
+		const double maxError = (double)targetError * targetError * radius * radius; //Quadric errors are squared distances
+
+		//Vertices sharing a position are one vertex as far as topology goes
+		std::vector<unsigned int> positionId(vertexCount);
+		std::vector<unsigned int> positionUses(vertexCount, 0);
+		{
+			struct Vec3Hash {
+				size_t operator()(const ew::Vec3& p) const {
+					unsigned int h[3];
+					memcpy(h, &p.x, sizeof(h));
+					return (h[0] * 73856093u) ^ (h[1] * 19349663u) ^ (h[2] * 83492791u);
+				}
+			};
+			struct Vec3Equal {
+				bool operator()(const ew::Vec3& a, const ew::Vec3& b) const { return a.x == b.x && a.y == b.y && a.z == b.z; }
+			};
+			std::unordered_map<ew::Vec3, unsigned int, Vec3Hash, Vec3Equal> firstAtPosition;
+			firstAtPosition.reserve(vertexCount);
+			for (size_t v = 0; v < vertexCount; v++)
+			{
+				positionId[v] = firstAtPosition.emplace(position((unsigned int)v), (unsigned int)v).first->second;
+				positionUses[positionId[v]]++;
+			}
+		}
+
+		//Locked vertices never move: seams, and borders (edges with a single triangle)
+		std::vector<bool> locked(vertexCount, false);
+		for (size_t v = 0; v < vertexCount; v++)
+			locked[v] = positionUses[positionId[v]] > 1;
+		{
+			std::unordered_map<unsigned long long, int> edgeUses;
+			edgeUses.reserve(result.size());
+			auto edgeKey = [](unsigned int a, unsigned int b) {
+				return a < b ? ((unsigned long long)a << 32) | b : ((unsigned long long)b << 32) | a;
+			};
+			for (size_t i = 0; i < result.size(); i += 3)
+				for (int k = 0; k < 3; k++)
+					edgeUses[edgeKey(positionId[result[i + k]], positionId[result[i + (k + 1) % 3]])]++;
+			for (size_t i = 0; i < result.size(); i += 3)
+				for (int k = 0; k < 3; k++)
+				{
+					const unsigned int a = result[i + k], b = result[i + (k + 1) % 3];
+					if (edgeUses[edgeKey(positionId[a], positionId[b])] == 1)
+						locked[a] = locked[b] = true;
+				}
+		}
+
+		//Area weighted plane quadrics of every triangle around each vertex
+		std::vector<Quadric> quadrics(vertexCount, Quadric{ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 });
+		for (size_t i = 0; i < result.size(); i += 3)
+		{
+			const ew::Vec3 p0 = position(result[i]), p1 = position(result[i + 1]), p2 = position(result[i + 2]);
+			const ew::Vec3 n = ew::Cross(p1 - p0, p2 - p0);
+			const float doubleArea = ew::Magnitude(n);
+			if (doubleArea <= 0)
+				continue;
+			const ew::Vec3 unit = n / doubleArea;
+			const Quadric q = planeQuadric(unit.x, unit.y, unit.z, -ew::Dot(unit, p0), doubleArea * 0.5);
+			for (int k = 0; k < 3; k++)
+				addQuadric(quadrics[result[i + k]], q);
+		}
+
+		std::vector<unsigned int> remap(vertexCount);
+		std::vector<bool> touched(vertexCount);
+		std::vector<size_t> adjacencyStart(vertexCount + 1);
+		std::vector<unsigned int> adjacency;
+		std::vector<Collapse> collapses;
+		double largestError = 0;
+
+		//Each pass collapses the cheapest independent edges, then rebuilds adjacency
+		while (result.size() > targetIndexCount)
+		{
+			//Triangles around each vertex
+			std::fill(adjacencyStart.begin(), adjacencyStart.end(), 0);
+			for (unsigned int v : result)
+				adjacencyStart[v + 1]++;
+			for (size_t v = 0; v < vertexCount; v++)
+				adjacencyStart[v + 1] += adjacencyStart[v];
+			adjacency.resize(result.size());
+			{
+				std::vector<size_t> fill(adjacencyStart.begin(), adjacencyStart.end() - 1);
+				for (size_t i = 0; i < result.size(); i++)
+					adjacency[fill[result[i]]++] = (unsigned int)(i / 3);
+			}
+
+			//Both directions of every edge, cheapest first
+			collapses.clear();
+			for (size_t i = 0; i < result.size(); i += 3)
+				for (int k = 0; k < 3; k++)
+				{
+					const unsigned int a = result[i + k], b = result[i + (k + 1) % 3];
+					if (!locked[a])
+						collapses.push_back({ a, b, quadricError(quadrics[a], position(b)) });
+					if (!locked[b])
+						collapses.push_back({ b, a, quadricError(quadrics[b], position(a)) });
+				}
+			if (collapses.empty())
+				break;
+			std::sort(collapses.begin(), collapses.end(), [](const Collapse& l, const Collapse& r) { return l.error < r.error; });
+
+			for (size_t v = 0; v < vertexCount; v++)
+				remap[v] = (unsigned int)v;
+			std::fill(touched.begin(), touched.end(), false);
+			//Every collapse removes about 2 triangles
+			const size_t trianglesToRemove = (result.size() - targetIndexCount) / 3;
+			size_t collapsed = 0;
+			for (const Collapse& c : collapses)
+			{
+				if (c.error > maxError || collapsed * 2 >= trianglesToRemove)
+					break;
+				if (touched[c.from] || touched[c.to])
+					continue;
+				//Reject collapses that would flip a triangle around from
+				bool flips = false;
+				const ew::Vec3 target = position(c.to);
+				for (size_t a = adjacencyStart[c.from]; a < adjacencyStart[c.from + 1] && !flips; a++)
+				{
+					const unsigned int* tri = &result[adjacency[a] * 3];
+					if (tri[0] == c.to || tri[1] == c.to || tri[2] == c.to)
+						continue;
+					ew::Vec3 before[3], after[3];
+					for (int k = 0; k < 3; k++)
+					{
+						before[k] = position(tri[k]);
+						after[k] = tri[k] == c.from ? target : before[k];
+					}
+					const ew::Vec3 nBefore = ew::Cross(before[1] - before[0], before[2] - before[0]);
+					const ew::Vec3 nAfter = ew::Cross(after[1] - after[0], after[2] - after[0]);
+					flips = ew::Dot(nBefore, nAfter) <= 0;
+				}
+				if (flips)
+					continue;
+				//Neither end may move again this pass, and neither may from's neighbours, whose triangles just changed
+				for (size_t a = adjacencyStart[c.from]; a < adjacencyStart[c.from + 1]; a++)
+				{
+					const unsigned int* tri = &result[adjacency[a] * 3];
+					touched[tri[0]] = touched[tri[1]] = touched[tri[2]] = true;
+				}
+				remap[c.from] = c.to;
+				addQuadric(quadrics[c.to], quadrics[c.from]);
+				largestError = std::max(largestError, c.error);
+				collapsed++;
+			}
+			if (collapsed == 0)
+				break;
+
+			//Apply and drop triangles that became degenerate
+			size_t write = 0;
+			for (size_t i = 0; i < result.size(); i += 3)
+			{
+				const unsigned int a = remap[result[i]], b = remap[result[i + 1]], c = remap[result[i + 2]];
+				if (a == b || b == c || c == a)
+					continue;
+				result[write++] = a;
+				result[write++] = b;
+				result[write++] = c;
+			}
+			result.resize(write);
+		}
+
+		if (resultError)
+			*resultError = (float)(sqrt(largestError) / radius);
+		std::copy(result.begin(), result.end(), destination);
+		return result.size();
+	}
+}
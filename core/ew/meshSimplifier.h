@@ -0,0 +1,20 @@
+#pragma once
+#include <stddef.h>
+#include <vector>
+
+namespace ew {
+	/// <summary>
+	/// Quadric error edge collapse simplification (Garland/Heckbert) that only rewrites indices. Each collapse moves a
+	/// vertex onto one of its neighbours, so the vertex buffer can be shared with the original mesh.
+	/// Border vertices and attribute seams (several vertices at one position) are never moved.
+	/// </summary>
+	/// <param name="destination">Room for indexCount indices. May be the same as indices</param>
+	/// <param name="positions">First position, 3 floats</param>
+	/// <param name="positionStride">Bytes between positions</param>
+	/// <param name="targetIndexCount">Stop once the mesh has this many indices or fewer</param>
+	/// <param name="targetError">Stop before any collapse with an error above this, relative to the mesh radius</param>
+	/// <param name="resultError">Optional. Largest error of the collapses made, relative to the mesh radius</param>
+	/// <returns>Number of indices written to destination</returns>
+	size_t SimplifyMesh(unsigned int* destination, const unsigned int* indices, size_t indexCount, const float* positions, size_t positionStride,
+		size_t vertexCount, size_t targetIndexCount, float targetError, float* resultError = nullptr);
+}
@@ -0,0 +1,236 @@
+#include "meshlet.h"
+#include "drawList.h"
+#include <math.h>
+
+namespace ew {
+	static const unsigned int NONE = 0xFFFFFFFF;
+
+	std::vector<Meshlet> BuildMeshlets(const unsigned int* indices, size_t indexCount, const float* positions, size_t positionStride, size_t vertexCount,
+		std::vector<unsigned int>& meshletIndices, size_t maxVertices, size_t maxTriangles)
+	{
+		auto position = [&](unsigned int v) {
+			const float* p = (const float*)((const unsigned char*)positions + v * positionStride);
+			return ew::Vec3(p[0], p[1], p[2]);
+		};
+		const size_t triangleCount = indexCount / 3;
+
+		//Unit facing of each triangle, zero when degenerate
+		std::vector<ew::Vec3> normals(triangleCount);
+		for (size_t t = 0; t < triangleCount; t++)
+		{
+			const ew::Vec3 a = position(indices[t * 3]);
+			const ew::Vec3 n = ew::Cross(position(indices[t * 3 + 1]) - a, position(indices[t * 3 + 2]) - a);
+			const float length = ew::Magnitude(n);
+			normals[t] = length > 0 ? n / length : ew::Vec3(0.0f);
+		}
+
+		//Triangles using each vertex, as offsets into one array
+		std::vector<unsigned int> adjacencyOffsets(vertexCount + 1, 0);
+		for (size_t i = 0; i < triangleCount * 3; i++)
+			adjacencyOffsets[indices[i] + 1]++;
+		for (size_t v = 0; v < vertexCount; v++)
+			adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+		std::vector<unsigned int> adjacency(triangleCount * 3);
+		{
+			std::vector<unsigned int> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+			for (size_t i = 0; i < triangleCount * 3; i++)
+				adjacency[fill[indices[i]]++] = (unsigned int)(i / 3);
+		}
+
+		std::vector<Meshlet> meshlets;
+		meshletIndices.clear();
+		meshletIndices.reserve(triangleCount * 3);
+		std::vector<bool> emitted(triangleCount, false);
+		std::vector<bool> inMeshlet(vertexCount, false);
+		std::vector<unsigned int> meshletVertices;
+		std::vector<unsigned int> candidates;
+		std::vector<unsigned int> candidateOf(triangleCount, NONE); //Meshlet a triangle was last queued for, so it is queued once
+		size_t seed = 0;
+
+		while (true)
+		{
+			//Each meshlet starts at the first triangle not yet used, so input locality carries over
+			while (seed < triangleCount && emitted[seed])
+				seed++;
+			if (seed == triangleCount)
+				break;
+
+			Meshlet meshlet;
+			meshlet.firstIndex = meshletIndices.size();
+			ew::Vec3 normalSum = ew::Vec3(0.0f);
+			size_t triangles = 0;
+			meshletVertices.clear();
+			candidates.clear();
+
+			for (unsigned int next = (unsigned int)seed; next != NONE;)
+			{
+				emitted[next] = true;
+				for (int k = 0; k < 3; k++)
+				{
+					const unsigned int v = indices[next * 3 + k];
+					meshletIndices.push_back(v);
+					if (!inMeshlet[v]) {
+						inMeshlet[v] = true;
+						meshletVertices.push_back(v);
+					}
+					for (unsigned int a = adjacencyOffsets[v]; a < adjacencyOffsets[v + 1]; a++)
+					{
+						const unsigned int t = adjacency[a];
+						if (!emitted[t] && candidateOf[t] != meshlets.size()) {
+							candidateOf[t] = (unsigned int)meshlets.size();
+							candidates.push_back(t);
+						}
+					}
+				}
+				normalSum += normals[next];
+				if (++triangles == maxTriangles)
+					break;
+
+				//Fewest new vertices first keeps the meshlet round, matching facing keeps its cone narrow
+				const float sumLength = ew::Magnitude(normalSum);
+				const ew::Vec3 axis = sumLength > 0 ? normalSum / sumLength : ew::Vec3(0.0f);
+				next = NONE;
+				int bestNew = 4;
+				float bestFacing = -2.0f;
+				size_t kept = 0;
+				for (size_t c = 0; c < candidates.size(); c++)
+				{
+					const unsigned int t = candidates[c];
+					if (emitted[t])
+						continue;
+					candidates[kept++] = t;
+					const unsigned int a = indices[t * 3], b = indices[t * 3 + 1], d = indices[t * 3 + 2];
+					const int newVertices = !inMeshlet[a] + (!inMeshlet[b] && b != a) + (!inMeshlet[d] && d != a && d != b);
+					if (meshletVertices.size() + newVertices > maxVertices)
+						continue;
+					const float facing = ew::Dot(normals[t], axis);
+					if (newVertices < bestNew || (newVertices == bestNew && facing > bestFacing)) {
+						next = t;
+						bestNew = newVertices;
+						bestFacing = facing;
+					}
+				}
+				candidates.resize(kept);
+			}
+			meshlet.indexCount = meshletIndices.size() - meshlet.firstIndex;
+			meshlet.vertexCount = meshletVertices.size();
+
+			//Sphere around the box of the vertices
+			ew::Vec3 min = ew::Vec3(INFINITY), max = ew::Vec3(-INFINITY);
+			for (unsigned int v : meshletVertices)
+			{
+				const ew::Vec3 p = position(v);
+				min = ew::Vec3(fminf(min.x, p.x), fminf(min.y, p.y), fminf(min.z, p.z));
+				max = ew::Vec3(fmaxf(max.x, p.x), fmaxf(max.y, p.y), fmaxf(max.z, p.z));
+				inMeshlet[v] = false;
+			}
+			meshlet.bounds.center = (min + max) * 0.5f;
+			float radiusSq = 0.0f;
+			for (unsigned int v : meshletVertices)
+			{
+				const ew::Vec3 d = position(v) - meshlet.bounds.center;
+				radiusSq = fmaxf(radiusSq, ew::Dot(d, d));
+			}
+			meshlet.bounds.radius = sqrtf(radiusSq);
+
+			//Normal cone: the widest angle between the average facing and any triangle
+			const float sumLength = ew::Magnitude(normalSum);
+			meshlet.coneAxis = sumLength > 0 ? normalSum / sumLength : ew::Vec3(0.0f);
+			float minFacing = sumLength > 0 ? 1.0f : -1.0f;
+			for (size_t i = meshlet.firstIndex; i < meshletIndices.size(); i += 3)
+			{
+				const ew::Vec3 a = position(meshletIndices[i]);
+				const ew::Vec3 n = ew::Cross(position(meshletIndices[i + 1]) - a, position(meshletIndices[i + 2]) - a);
+				const float length = ew::Magnitude(n);
+				if (length > 0)
+					minFacing = fminf(minFacing, ew::Dot(n / length, meshlet.coneAxis));
+			}
+			meshlet.coneCos = minFacing;
+			meshlet.coneSin = sqrtf(fmaxf(0.0f, 1.0f - minFacing * minFacing));
+			meshlets.push_back(meshlet);
+		}
+		return meshlets;
+	}
+
+	std::vector<Meshlet> BuildMeshlets(MeshData& mesh, size_t maxVertices, size_t maxTriangles)
+	{
+		std::vector<unsigned int> meshletIndices;
+		std::vector<Meshlet> meshlets = BuildMeshlets(mesh.indices.data(), mesh.indices.size(), &mesh.vertices[0].pos.x, sizeof(Vertex), mesh.vertices.size(),
+			meshletIndices, maxVertices, maxTriangles);
+		mesh.indices.swap(meshletIndices);
+		return meshlets;
+	}
+
+	MeshletView MakeMeshletView(const Camera& camera, const ew::Mat4& model)
+	{
+		MeshletView view;
+		//Planes of the full clip transform are already in model space
+		view.frustum = ExtractFrustum(camera.ProjectionMatrix() * camera.ViewMatrix() * model);
+		//Inverse of the upper 3x3 is the transpose of its inverse transpose. Facing is preserved under the inverse,
+		//so cones are tested against the model space camera
+		const ew::Mat3 inverse = ew::Transpose(ew::NormalMatrix(model));
+		view.orthographic = camera.orthographic;
+		if (camera.orthographic)
+			view.eye = ew::Normalize(inverse * (camera.target - camera.position));
+		else
+			view.eye = inverse * (camera.position - ew::Vec3(model.get(3, 0), model.get(3, 1), model.get(3, 2)));
+		return view;
+	}
+
+	bool IsVisible(const MeshletView& view, const Meshlet& meshlet)
+	{
+		if (!IsVisible(view.frustum, meshlet.bounds))
+			return false;
+		if (meshlet.coneCos <= 0)
+			return true;
+		//Every triangle faces away when each view ray into the sphere is within 90 degrees minus the cone angle of the axis
+		if (view.orthographic)
+			return ew::Dot(meshlet.coneAxis, view.eye) < meshlet.coneSin;
+		const ew::Vec3 toCenter = meshlet.bounds.center - view.eye;
+		const float distanceSq = ew::Dot(toCenter, toCenter);
+		const float radius = meshlet.bounds.radius;
+		if (distanceSq <= radius * radius)
+			return true;
+		//cos and sin of the sphere's angular radius, times the distance
+		const float tangent = sqrtf(distanceSq - radius * radius);
+		if (meshlet.coneCos * tangent < meshlet.coneSin * radius)
+			return true;
+		return ew::Dot(meshlet.coneAxis, toCenter) < meshlet.coneSin * tangent + meshlet.coneCos * radius;
+	}
+
+	size_t CullMeshlets(const MeshletView& view, const Meshlet* meshlets, size_t count, const unsigned int* meshletIndices, std::vector<unsigned int>& out)
+	{
+		size_t kept = 0;
+		for (size_t i = 0; i < count; i++)
+		{
+			if (!IsVisible(view, meshlets[i]))
+				continue;
+			out.insert(out.end(), meshletIndices + meshlets[i].firstIndex, meshletIndices + meshlets[i].firstIndex + meshlets[i].indexCount);
+			kept++;
+		}
+		return kept;
+	}
+
+	size_t CullMeshlets(const MeshletView& view, const Meshlet* meshlets, size_t count, DrawList& drawList, int arenaMesh, const ew::Mat4& model, size_t firstIndex)
+	{
+		size_t kept = 0;
+		size_t runStart = 0, runCount = 0;
+		for (size_t i = 0; i < count; i++)
+		{
+			if (!IsVisible(view, meshlets[i]))
+				continue;
+			kept++;
+			if (runCount > 0 && runStart + runCount == meshlets[i].firstIndex) {
+				runCount += meshlets[i].indexCount;
+				continue;
+			}
+			if (runCount > 0)
+				drawList.add(arenaMesh, firstIndex + runStart, runCount, model);
+			runStart = meshlets[i].firstIndex;
+			runCount = meshlets[i].indexCount;
+		}
+		if (runCount > 0)
+			drawList.add(arenaMesh, firstIndex + runStart, runCount, model);
+		return kept;
+	}
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <vector>
+#include <stddef.h>
+#include "mesh.h"
+#include "camera.h"
+#include "frustum.h"
+
+namespace ew {
+	class DrawList;
+
+	const size_t MESHLET_MAX_VERTICES = 64;
+	const size_t MESHLET_MAX_TRIANGLES = 124;
+
+	//A small cluster of triangles: a contiguous range of a reordered index buffer, with bounds for culling
+	struct Meshlet {
+		size_t firstIndex;
+		size_t indexCount;
+		size_t vertexCount; //Unique vertices referenced
+		BoundingSphere bounds; //Model space
+		ew::Vec3 coneAxis; //Average facing of the triangles
+		float coneSin; //Sine and cosine of the angle between coneAxis and the furthest triangle normal.
+		float coneCos; //coneCos <= 0 means the normals are too spread out to ever back face cull
+	};
+
+	/// <summary>
+	/// Splits a triangle list into meshlets of at most maxVertices unique vertices and maxTriangles triangles.
+	/// Meshlets grow through shared vertices, preferring triangles that add fewest new vertices, then ones facing the same way,
+	/// so they stay compact and their normal cones stay narrow.
+	/// </summary>
+	/// <param name="meshletIndices">Cleared, then filled with the input triangles in meshlet order</param>
+	/// <returns>The meshlets, in the order their triangles appear in meshletIndices</returns>
+	std::vector<Meshlet> BuildMeshlets(const unsigned int* indices, size_t indexCount, const float* positions, size_t positionStride, size_t vertexCount,
+		std::vector<unsigned int>& meshletIndices, size_t maxVertices = MESHLET_MAX_VERTICES, size_t maxTriangles = MESHLET_MAX_TRIANGLES);
+	//Reorders mesh.indices into meshlet order
+	std::vector<Meshlet> BuildMeshlets(MeshData& mesh, size_t maxVertices = MESHLET_MAX_VERTICES, size_t maxTriangles = MESHLET_MAX_TRIANGLES);
+
+	//Camera brought into one object's model space, so meshlets are tested without transforming their bounds
+	struct MeshletView {
+		Frustum frustum; //Model space planes
+		ew::Vec3 eye; //Model space camera position, or view direction when orthographic
+		bool orthographic;
+	};
+	MeshletView MakeMeshletView(const Camera& camera, const ew::Mat4& model);
+
+	//False when the meshlet is outside the frustum or every triangle in it faces away from the camera
+	bool IsVisible(const MeshletView& view, const Meshlet& meshlet);
+
+	/// <summary>
+	/// Per frame culling pass. Appends the indices of visible meshlets, back to back, to out.
+	/// </summary>
+	/// <returns>Number of meshlets kept</returns>
+	size_t CullMeshlets(const MeshletView& view, const Meshlet* meshlets, size_t count, const unsigned int* meshletIndices, std::vector<unsigned int>& out);
+	/// <summary>
+	/// Same, but adds draws of arenaMesh to drawList instead of copying indices. Runs of neighbouring visible meshlets share one draw.
+	/// The arena mesh's indices must be the meshletIndices the meshlets were built with, firstIndex is added to every range
+	/// </summary>
+	size_t CullMeshlets(const MeshletView& view, const Meshlet* meshlets, size_t count, DrawList& drawList, int arenaMesh, const ew::Mat4& model,
+		size_t firstIndex = 0);
+}
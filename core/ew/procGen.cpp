@@ -5,6 +5,10 @@
 
 #include "procGen.h"
 #include <stdlib.h>
+#include <vector>
+#include <algorithm>
+#include "ewMath/trig.h"
+#include "threadPool.h"
 
 namespace ew {
 	/// <summary>
@@ -12,9 +16,10 @@ namespace ew {
 	/// </summary>
 	/// <param name="normal">Normal direction of the face</param>
 	/// <param name="size">Width/height of the face</param>
-	/// <param name="mesh">MeshData struct to fill</param>
-	static void createCubeFace(ew::Vec3 normal, float size, MeshData* mesh) {
-		unsigned int startVertex = mesh->vertices.size();
+	/// <param name="vertices">Destination for the face's 4 vertices</param>
+	/// <param name="indices">Destination for the face's 6 indices</param>
+	/// <param name="startVertex">Index of the face's first vertex in the mesh</param>
+	static void createCubeFace(ew::Vec3 normal, float size, Vertex* vertices, unsigned int* indices, unsigned int startVertex) {
 		ew::Vec3 a = ew::Vec3(normal.z, normal.x, normal.y); //U axis
 		ew::Vec3 b = ew::Cross(normal, a); //V axis
 		for (int i = 0; i < 4; i++)
@@ -22,23 +27,21 @@ namespace ew {
 			int col = i % 2;
 			int row = i / 2;
 
-			ew::Vec3 pos = normal * size * 0.5f;
-			pos -= (a + b) * size * 0.5f;
-			pos += (a * col + b * row) * size;
-			Vertex vertex;// = &mesh->vertices[mesh->vertices.size()];
+			//normal * size/2 + a * (col - 0.5) * size + b * (row - 0.5) * size
+			const ew::Vec3 pos = ew::ScaleAdd(a, (col - 0.5f) * size, ew::ScaleAdd(b, (row - 0.5f) * size, normal * (size * 0.5f)));
+			Vertex& vertex = vertices[i];
 			vertex.pos = pos;
 			vertex.normal = normal;
 			vertex.uv = ew::Vec2(col, row);
-			mesh->vertices.push_back(vertex);
 		}
 
 		//Indices
-		mesh->indices.push_back(startVertex);
-		mesh->indices.push_back(startVertex + 1);
-		mesh->indices.push_back(startVertex + 3);
-		mesh->indices.push_back(startVertex + 3);
-		mesh->indices.push_back(startVertex + 2);
-		mesh->indices.push_back(startVertex);
+		indices[0] = startVertex;
+		indices[1] = startVertex + 1;
+		indices[2] = startVertex + 3;
+		indices[3] = startVertex + 3;
+		indices[4] = startVertex + 2;
+		indices[5] = startVertex;
 	}
 	/// <summary>
 	/// Creates a cube of uniform size
@@ -47,117 +50,201 @@ namespace ew {
 	/// <param name="mesh">MeshData struct to fill. Will be cleared.</param>
 	MeshData createCube(float size) {
 		MeshData mesh;
-		mesh.vertices.reserve(24); //6 x 4 vertices
-		mesh.indices.reserve(36); //6 x 6 indices
-		createCubeFace(ew::Vec3{ +0.0f,+0.0f,+1.0f }, size, &mesh); //Front
-		createCubeFace(ew::Vec3{ +1.0f,+0.0f,+0.0f }, size, &mesh); //Right
-		createCubeFace(ew::Vec3{ +0.0f,+1.0f,+0.0f }, size, &mesh); //Top
-		createCubeFace(ew::Vec3{ -1.0f,+0.0f,+0.0f }, size, &mesh); //Left
-		createCubeFace(ew::Vec3{ +0.0f,-1.0f,+0.0f }, size, &mesh); //Bottom
-		createCubeFace(ew::Vec3{ +0.0f,+0.0f,-1.0f }, size, &mesh); //Back
+		const MeshCounts counts = queryCubeCounts();
+		mesh.vertices.resize(counts.numVertices);
+		mesh.indices.resize(counts.numIndices);
+		createCube(size, mesh.vertices.data(), mesh.indices.data());
 		return mesh;
 	}
-	MeshData createPlane(float width, float height, int subdivisions)
+	MeshCounts queryCubeCounts()
 	{
-		//VERTICES
-		MeshData mesh;
-		int columns = subdivisions + 1;
-		for (size_t row = 0; row <= subdivisions; row++)
+		return { 24, 36 }; //6 x 4 vertices, 6 x 6 indices
+	}
+	void createCube(float size, Vertex* vertices, unsigned int* indices)
+	{
+		const ew::Vec3 normals[6] = {
+			ew::Vec3{ +0.0f,+0.0f,+1.0f }, //Front
+			ew::Vec3{ +1.0f,+0.0f,+0.0f }, //Right
+			ew::Vec3{ +0.0f,+1.0f,+0.0f }, //Top
+			ew::Vec3{ -1.0f,+0.0f,+0.0f }, //Left
+			ew::Vec3{ +0.0f,-1.0f,+0.0f }, //Bottom
+			ew::Vec3{ +0.0f,+0.0f,-1.0f } //Back
+		};
+		for (int i = 0; i < 6; i++)
 		{
-			for (size_t col = 0; col <= subdivisions; col++)
-			{
-				Vertex v;
-				v.uv.x = ((float)col / subdivisions);
-				v.uv.y = ((float)row / subdivisions);
-				v.pos.x = -width/2 + width * v.uv.x;
-				v.pos.y = 0;
-				v.pos.z = height/2 -height * v.uv.y;
-				v.normal = ew::Vec3(0, 1, 0);
-				mesh.vertices.push_back(v);
-			}
+			createCubeFace(normals[i], size, vertices + i * 4, indices + i * 6, i * 4);
 		}
-		//INDICES
-		for (size_t row = 0; row < subdivisions; row++)
-		{
-			for (size_t col = 0; col < subdivisions; col++)
+	}
+	//Rows are handed to the thread pool in chunks of about this many vertices, so small meshes stay on the calling thread
+	static const size_t MIN_CHUNK_VERTICES = 16384;
+	static size_t rowsPerChunk(size_t verticesPerRow) {
+		return std::max((size_t)1, MIN_CHUNK_VERTICES / std::max(verticesPerRow, (size_t)1));
+	}
+	static ThreadPool& poolOrGlobal(ThreadPool* pool) {
+		return pool ? *pool : ThreadPool::global();
+	}
+
+	MeshData createPlane(float width, float height, int subdivisions, ThreadPool* pool)
+	{
+		MeshData mesh;
+		const MeshCounts counts = queryPlaneCounts(subdivisions);
+		mesh.vertices.resize(counts.numVertices);
+		mesh.indices.resize(counts.numIndices);
+		createPlane(width, height, subdivisions, mesh.vertices.data(), mesh.indices.data(), pool);
+		return mesh;
+	}
+	MeshCounts queryPlaneCounts(int subdivisions)
+	{
+		const size_t columns = subdivisions + 1;
+		return { columns * columns, 6 * (size_t)subdivisions * subdivisions };
+	}
+	void createPlane(float width, float height, int subdivisions, Vertex* vertices, unsigned int* indices, ThreadPool* pool)
+	{
+		const size_t columns = subdivisions + 1;
+		//Every row writes its own slice of vertices and indices, so rows can be filled in any order
+		poolOrGlobal(pool).parallelFor(columns, rowsPerChunk(columns), [=](size_t rowBegin, size_t rowEnd) {
+			for (size_t row = rowBegin; row < rowEnd; row++)
 			{
-				int start = row * columns + col;
-				mesh.indices.push_back(start);
-				mesh.indices.push_back(start + 1);
-				mesh.indices.push_back(start + columns + 1);
-				mesh.indices.push_back(start + columns + 1);
-				mesh.indices.push_back(start + columns);
-				mesh.indices.push_back(start);
+				//VERTICES
+				//Vertices are built locally and written once, the destination may be write only mapped memory
+				Vertex* v = vertices + row * columns;
+				for (size_t col = 0; col <= subdivisions; col++, v++)
+				{
+					Vertex vertex;
+					vertex.uv.x = ((float)col / subdivisions);
+					vertex.uv.y = ((float)row / subdivisions);
+					vertex.pos.x = -width / 2 + width * vertex.uv.x;
+					vertex.pos.y = 0;
+					vertex.pos.z = height / 2 - height * vertex.uv.y;
+					vertex.normal = ew::Vec3(0, 1, 0);
+					*v = vertex;
+				}
+				//INDICES
+				if (row == subdivisions)
+					continue;
+				unsigned int* i = indices + row * subdivisions * 6;
+				for (size_t col = 0; col < subdivisions; col++)
+				{
+					unsigned int start = row * columns + col;
+					*i++ = start;
+					*i++ = start + 1;
+					*i++ = start + columns + 1;
+					*i++ = start + columns + 1;
+					*i++ = start + columns;
+					*i++ = start;
+				}
 			}
-		}
-		return mesh;
+		});
 	}
-	MeshData createSphere(float radius, int subdivisions)
+	MeshData createSphere(float radius, int subdivisions, ThreadPool* pool)
 	{
 		MeshData mesh;
-		//VERTICES
+		const MeshCounts counts = querySphereCounts(subdivisions);
+		mesh.vertices.resize(counts.numVertices);
+		mesh.indices.resize(counts.numIndices);
+		createSphere(radius, subdivisions, mesh.vertices.data(), mesh.indices.data(), pool);
+		return mesh;
+	}
+	MeshCounts querySphereCounts(int subdivisions)
+	{
+		const size_t columns = subdivisions + 1;
+		const size_t sideRows = subdivisions > 2 ? subdivisions - 2 : 0;
+		//Top cap, side quads, bottom cap
+		return { columns * columns, 3 * (size_t)subdivisions + 6 * sideRows * subdivisions + 3 * (size_t)subdivisions };
+	}
+	void createSphere(float radius, int subdivisions, Vertex* vertices, unsigned int* indices, ThreadPool* pool)
+	{
+		const size_t columns = subdivisions + 1;
+		const size_t sideRows = subdivisions > 2 ? subdivisions - 2 : 0;
+
 		float thetaStep = ew::TAU / subdivisions;
 		float phiStep = ew::PI / subdivisions;
-		for (size_t row = 0; row <= subdivisions; row++)
-		{
-			float phi = row * phiStep;
-			for (size_t col = 0; col <= subdivisions; col++)
+		//Every row shares the same thetas and every column the same phis, so compute each once
+		std::vector<float> angles(subdivisions + 1);
+		std::vector<float> sinThetaTable(subdivisions + 1), cosThetaTable(subdivisions + 1);
+		std::vector<float> sinPhiTable(subdivisions + 1), cosPhiTable(subdivisions + 1);
+		for (size_t i = 0; i <= subdivisions; i++)
+			angles[i] = thetaStep * i;
+		ew::SinCosN(angles.data(), sinThetaTable.data(), cosThetaTable.data(), angles.size());
+		for (size_t i = 0; i <= subdivisions; i++)
+			angles[i] = i * phiStep;
+		ew::SinCosN(angles.data(), sinPhiTable.data(), cosPhiTable.data(), angles.size());
+		const float* sinTheta = sinThetaTable.data();
+		const float* cosTheta = cosThetaTable.data();
+		const float* sinPhi = sinPhiTable.data();
+		const float* cosPhi = cosPhiTable.data();
+
+		//VERTICES
+		poolOrGlobal(pool).parallelFor(columns, rowsPerChunk(columns), [=](size_t rowBegin, size_t rowEnd) {
+			for (size_t row = rowBegin; row < rowEnd; row++)
 			{
-				float theta = thetaStep * col;
-				Vertex v;
-				v.normal.x = cosf(theta) * sinf(phi);
-				v.normal.y = cosf(phi);
-				v.normal.z = sinf(theta) * sinf(phi);
-				v.pos = v.normal * radius;
-				v.uv.x = (float)col / subdivisions;
-				v.uv.y = 1.0 - ((float)row / subdivisions);
-				mesh.vertices.push_back(v);
+				Vertex* v = vertices + row * columns;
+				for (size_t col = 0; col <= subdivisions; col++, v++)
+				{
+					Vertex vertex;
+					vertex.normal.x = cosTheta[col] * sinPhi[row];
+					vertex.normal.y = cosPhi[row];
+					vertex.normal.z = sinTheta[col] * sinPhi[row];
+					vertex.pos = vertex.normal * radius;
+					vertex.uv.x = (float)col / subdivisions;
+					vertex.uv.y = 1.0 - ((float)row / subdivisions);
+					*v = vertex;
+				}
 			}
-		}
-		
+		});
+
 		//INDICES
-		unsigned int columns = subdivisions + 1;
 		unsigned int sideStart = columns;
 		unsigned int poleStart = 0;
+		unsigned int* i = indices;
 		//Top cap
-		for (size_t i = 0; i < subdivisions; i++)
+		for (size_t col = 0; col < subdivisions; col++)
 		{
-			mesh.indices.push_back(sideStart + i);
-			mesh.indices.push_back(poleStart + i);
-			mesh.indices.push_back(sideStart +i+1);
+			*i++ = sideStart + col;
+			*i++ = poleStart + col;
+			*i++ = sideStart + col + 1;
 		}
 		//Rows of quads for sides
-		for (size_t row = 1; row < subdivisions - 1; row++)
-		{
-			for (size_t col = 0; col < subdivisions; col++)
+		unsigned int* sideIndices = i;
+		poolOrGlobal(pool).parallelFor(sideRows, rowsPerChunk(columns), [=](size_t rowBegin, size_t rowEnd) {
+			for (size_t sideRow = rowBegin; sideRow < rowEnd; sideRow++)
 			{
-				int start = row * columns + col;
-				mesh.indices.push_back(start);
-				mesh.indices.push_back(start + 1);
-				mesh.indices.push_back(start + columns);
-				mesh.indices.push_back(start + columns);
-				mesh.indices.push_back(start + 1);
-				mesh.indices.push_back(start + columns + 1);
+				const size_t row = sideRow + 1;
+				unsigned int* i = sideIndices + sideRow * subdivisions * 6;
+				for (size_t col = 0; col < subdivisions; col++)
+				{
+					unsigned int start = row * columns + col;
+					*i++ = start;
+					*i++ = start + 1;
+					*i++ = start + columns;
+					*i++ = start + columns;
+					*i++ = start + 1;
+					*i++ = start + columns + 1;
+				}
 			}
-		}
+		});
+		i += sideRows * subdivisions * 6;
 		//Bottom cap
 		poleStart = (columns * columns) - columns;
 		sideStart = poleStart - columns;
-		for (size_t i = 0; i < subdivisions; i++)
+		for (size_t col = 0; col < subdivisions; col++)
 		{
-			mesh.indices.push_back(sideStart + i);
-			mesh.indices.push_back(sideStart + i + 1);
-			mesh.indices.push_back(poleStart + i);
+			*i++ = sideStart + col;
+			*i++ = sideStart + col + 1;
+			*i++ = poleStart + col;
 		}
-		return mesh;
 	}
-	void createCylinderRing(MeshData* meshData, float radius, int subdivisions, float y, bool sideFacing) {
-		float thetaStep = ew::TAU / subdivisions;
+	/// <summary>
+	/// Helper function for createCylinder. Writes subdivisions+1 vertices around a ring.
+	/// </summary>
+	/// <param name="vertices">Destination for the ring's vertices</param>
+	/// <param name="sinTheta">Precomputed sine of each ring angle</param>
+	/// <param name="cosTheta">Precomputed cosine of each ring angle</param>
+	void createCylinderRing(Vertex* vertices, float radius, int subdivisions, float y, bool sideFacing, const float* sinTheta, const float* cosTheta) {
 		for (size_t i = 0; i <= subdivisions; i++)
 		{
-			float theta = i * thetaStep;
-			float cosA = cosf(theta);
-			float sinA = sinf(theta);
+			float cosA = cosTheta[i];
+			float sinA = sinTheta[i];
 			ew::Vertex v;
 			v.pos = ew::Vec3(cosA * radius, y, sinA * radius);
 			if (sideFacing) {
@@ -168,13 +255,28 @@ namespace ew {
 				v.normal = ew::Vec3(0, ew::Sign(y), 0);
 				v.uv = ew::Vec2(cosA * 0.5 + 0.5, sinA * 0.5 + 0.5);
 			}
-
-			meshData->vertices.push_back(v);
+			vertices[i] = v;
 		}
 	}
-	MeshData createCylinder(float radius, float height, int subdivisions)
+	MeshData createCylinder(float radius, float height, int subdivisions, ThreadPool* pool)
 	{
 		MeshData mesh;
+		const MeshCounts counts = queryCylinderCounts(subdivisions);
+		mesh.vertices.resize(counts.numVertices);
+		mesh.indices.resize(counts.numIndices);
+		createCylinder(radius, height, subdivisions, mesh.vertices.data(), mesh.indices.data(), pool);
+		return mesh;
+	}
+	MeshCounts queryCylinderCounts(int subdivisions)
+	{
+		const size_t columns = subdivisions + 1;
+		//Center, 4 rings, center. Top cap, sides, bottom cap
+		return { 4 * columns + 2, 3 * columns + 6 * columns + 3 * columns };
+	}
+	void createCylinder(float radius, float height, int subdivisions, Vertex* vertices, unsigned int* indices, ThreadPool* pool)
+	{
+		const size_t columns = subdivisions + 1;
+		const size_t numVertices = 4 * columns + 2;
 
 		//VERTICES
 		{
@@ -185,53 +287,66 @@ namespace ew {
 			topVertex.pos = ew::Vec3(0, topY, 0);
 			topVertex.normal = ew::Vec3(0, 1, 0);
 			topVertex.uv = ew::Vec2(0.5);
-			mesh.vertices.push_back(topVertex);
+			vertices[0] = topVertex;
+
+			//All 4 rings share the same angles
+			float thetaStep = ew::TAU / subdivisions;
+			std::vector<float> thetas(subdivisions + 1), sinThetaTable(subdivisions + 1), cosThetaTable(subdivisions + 1);
+			for (size_t i = 0; i <= subdivisions; i++)
+				thetas[i] = i * thetaStep;
+			ew::SinCosN(thetas.data(), sinThetaTable.data(), cosThetaTable.data(), thetas.size());
+			const float* sinTheta = sinThetaTable.data();
+			const float* cosTheta = cosThetaTable.data();
 
-			createCylinderRing(&mesh, radius, subdivisions, topY, false);
-			createCylinderRing(&mesh, radius, subdivisions, topY, true);
-			createCylinderRing(&mesh, radius, subdivisions, bottomY, true);
-			createCylinderRing(&mesh, radius, subdivisions, bottomY, false);
+			//Rings are independent
+			poolOrGlobal(pool).parallelFor(4, columns >= MIN_CHUNK_VERTICES ? 1 : 4, [=](size_t ringBegin, size_t ringEnd) {
+				for (size_t ring = ringBegin; ring < ringEnd; ring++)
+				{
+					const float y = ring < 2 ? topY : bottomY;
+					const bool sideFacing = ring == 1 || ring == 2;
+					createCylinderRing(vertices + 1 + ring * columns, radius, subdivisions, y, sideFacing, sinTheta, cosTheta);
+				}
+			});
 
 			ew::Vertex bottomVertex;
 			bottomVertex.pos = ew::Vec3(0, bottomY, 0);
 			bottomVertex.normal = ew::Vec3(0, -1, 0);
 			bottomVertex.uv = ew::Vec2(0.5);
-			mesh.vertices.push_back(bottomVertex);
+			vertices[numVertices - 1] = bottomVertex;
 		}
 		
 
 		//INDICES
 		{
-			int columns = subdivisions + 1;
+			unsigned int* i = indices;
 			//Top cap
-			for (size_t i = 0; i < columns; i++)
+			for (size_t col = 0; col < columns; col++)
 			{
-				mesh.indices.push_back(0);
-				mesh.indices.push_back(i + 1);
-				mesh.indices.push_back(i);
+				*i++ = 0;
+				*i++ = col + 1;
+				*i++ = col;
 			}
-			int sideStart = columns;
+			unsigned int sideStart = columns;
 			//Sides
-			for (size_t i = 0; i < columns; i++)
+			for (size_t col = 0; col < columns; col++)
 			{
-				int start = sideStart + i;
-				mesh.indices.push_back(start);
-				mesh.indices.push_back(start + 1);
-				mesh.indices.push_back(start + columns);
-				mesh.indices.push_back(start + columns);
-				mesh.indices.push_back(start + 1);
-				mesh.indices.push_back(start + columns + 1);
+				unsigned int start = sideStart + col;
+				*i++ = start;
+				*i++ = start + 1;
+				*i++ = start + columns;
+				*i++ = start + columns;
+				*i++ = start + 1;
+				*i++ = start + columns + 1;
 			}
 			//Bottom cap
-			int bottomIndex = mesh.vertices.size() - 1;
+			unsigned int bottomIndex = numVertices - 1;
 			sideStart = bottomIndex - columns;
-			for (size_t i = 0; i < columns; i++)
+			for (size_t col = 0; col < columns; col++)
 			{
-				mesh.indices.push_back(bottomIndex);
-				mesh.indices.push_back(sideStart + i);
-				mesh.indices.push_back(sideStart + i + 1);
+				*i++ = bottomIndex;
+				*i++ = sideStart + col;
+				*i++ = sideStart + col + 1;
 			}
 		}
-		return mesh;
 	}
 }
\ No newline at end of file
@@ -7,8 +7,23 @@
 #include "mesh.h"
 
 namespace ew {
+	class ThreadPool;
+
+	//Generators size their buffers exactly up front and fill rows in parallel on pool (ThreadPool::global() if null)
 	MeshData createCube(float size);
-	MeshData createPlane(float width, float height, int subdivisions);
-	MeshData createSphere(float radius, int subdivisions);
-	MeshData createCylinder(float radius, float height, int subdivisions);
+	MeshData createPlane(float width, float height, int subdivisions, ThreadPool* pool = nullptr);
+	MeshData createSphere(float radius, int subdivisions, ThreadPool* pool = nullptr);
+	MeshData createCylinder(float radius, float height, int subdivisions, ThreadPool* pool = nullptr);
+
+	//Exact vertex and index counts each generator will write
+	MeshCounts queryCubeCounts();
+	MeshCounts queryPlaneCounts(int subdivisions);
+	MeshCounts querySphereCounts(int subdivisions);
+	MeshCounts queryCylinderCounts(int subdivisions);
+
+	//In place versions. vertices and indices must have room for the matching query*Counts, e.g. a mapped GPU buffer (see Mesh::load)
+	void createCube(float size, Vertex* vertices, unsigned int* indices);
+	void createPlane(float width, float height, int subdivisions, Vertex* vertices, unsigned int* indices, ThreadPool* pool = nullptr);
+	void createSphere(float radius, int subdivisions, Vertex* vertices, unsigned int* indices, ThreadPool* pool = nullptr);
+	void createCylinder(float radius, float height, int subdivisions, Vertex* vertices, unsigned int* indices, ThreadPool* pool = nullptr);
 }
@@ -0,0 +1,90 @@
+#include "ringBuffer.h"
+#include "external/glad.h"
+#include <stdio.h>
+#include <algorithm>
+
+namespace ew {
+	RingBuffer::RingBuffer(size_t frameSize)
+	{
+		//allocate aligns within a region, so every region has to start on the strictest alignment asked for
+		const size_t regionAlignment = std::max(getUniformAlignment(), (size_t)16);
+		m_frameSize = (frameSize + regionAlignment - 1) / regionAlignment * regionAlignment;
+
+		//Coherent, so writes are visible to the GPU without flushing
+		const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		const GLsizeiptr size = m_frameSize * FRAMES;
+		glGenBuffers(1, &m_buffer);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, m_buffer);
+		glBufferStorage(GL_COPY_WRITE_BUFFER, size, NULL, flags);
+		m_mapped = (unsigned char*)glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, size, flags);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+		if (!m_mapped)
+			printf("Failed to map ring buffer\n");
+		//The first beginFrame moves to region 0
+		m_frame = FRAMES - 1;
+		m_head = m_frameSize;
+	}
+
+	RingBuffer::~RingBuffer()
+	{
+		for (int i = 0; i < FRAMES; i++)
+		{
+			if (m_fences[i])
+				glDeleteSync((GLsync)m_fences[i]);
+		}
+		glBindBuffer(GL_COPY_WRITE_BUFFER, m_buffer);
+		glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+		glDeleteBuffers(1, &m_buffer);
+	}
+
+	void RingBuffer::beginFrame()
+	{
+		m_frame = (m_frame + 1) % FRAMES;
+		m_head = 0;
+		GLsync fence = (GLsync)m_fences[m_frame];
+		if (!fence)
+			return;
+		//Only blocks when the CPU is FRAMES frames ahead of the GPU
+		GLenum result = glClientWaitSync(fence, 0, 0);
+		while (result == GL_TIMEOUT_EXPIRED)
+		{
+			result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000); //1ms
+		}
+		glDeleteSync(fence);
+		m_fences[m_frame] = nullptr;
+	}
+
+	void RingBuffer::endFrame()
+	{
+		if (m_fences[m_frame])
+			glDeleteSync((GLsync)m_fences[m_frame]);
+		m_fences[m_frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
+
+	RingAllocation RingBuffer::allocate(size_t size, size_t alignment)
+	{
+		RingAllocation allocation;
+		const size_t start = (m_head + alignment - 1) / alignment * alignment;
+		if (!m_mapped || start + size > m_frameSize)
+			return allocation;
+		m_head = start + size;
+		allocation.offset = m_frame * m_frameSize + start;
+		allocation.data = m_mapped + allocation.offset;
+		allocation.size = size;
+		allocation.buffer = m_buffer;
+		return allocation;
+	}
+
+	void RingBuffer::bindUniform(unsigned int binding, const RingAllocation& allocation) const
+	{
+		glBindBufferRange(GL_UNIFORM_BUFFER, binding, allocation.buffer, allocation.offset, allocation.size);
+	}
+
+	size_t RingBuffer::getUniformAlignment()
+	{
+		GLint alignment = 256;
+		glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+		return (size_t)alignment;
+	}
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <stddef.h>
+
+namespace ew {
+	//Part of a RingBuffer written by the CPU this frame
+	struct RingAllocation {
+		void* data = nullptr; //Persistently mapped, write only. NULL if the frame's region was full
+		size_t offset = 0; //Byte offset into buffer, for attribute pointers, draw offsets and glBindBufferRange
+		size_t size = 0;
+		unsigned int buffer = 0;
+	};
+
+	/// <summary>
+	/// One persistently mapped buffer split into FRAMES regions, for data that is rewritten every frame: vertices,
+	/// instances, uniforms. The CPU writes one region while the GPU reads the others, and a fence per region keeps the
+	/// CPU from overwriting data the GPU hasn't finished with. No orphaning, no mapping per upload.
+	/// Allocations stay valid until the same region comes around again, FRAMES - 1 frames later.
+	/// </summary>
+	class RingBuffer {
+	public:
+		static const int FRAMES = 3;
+		//frameSize is rounded up to a multiple of getUniformAlignment(), and at least 16, so each region starts aligned
+		RingBuffer(size_t frameSize);
+		~RingBuffer();
+		RingBuffer(const RingBuffer&) = delete;
+		RingBuffer& operator=(const RingBuffer&) = delete;
+		//Moves to the next region, waiting for the GPU if it is still reading it. Call before the frame's first allocate
+		void beginFrame();
+		//Fences the current region. Call after the frame's last draw that reads from it
+		void endFrame();
+		//size bytes of the current region at a multiple of alignment. Check data, it is NULL when the region is full
+		RingAllocation allocate(size_t size, size_t alignment = 16);
+		//Binds a uniform block to an allocation made with getUniformAlignment()
+		void bindUniform(unsigned int binding, const RingAllocation& allocation)const;
+		inline unsigned int getBuffer()const { return m_buffer; }
+		inline size_t getFrameSize()const { return m_frameSize; }
+		//Bytes of the current region still free
+		inline size_t getRemaining()const { return m_frameSize - m_head; }
+		//GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, for uniform allocations
+		static size_t getUniformAlignment();
+	private:
+		unsigned int m_buffer = 0;
+		unsigned char* m_mapped = nullptr;
+		size_t m_frameSize;
+		size_t m_head = 0; //Bytes used in the current region
+		int m_frame = 0;
+		void* m_fences[FRAMES] = {}; //GLsync of the last frame that used each region
+	};
+}
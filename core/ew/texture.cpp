@@ -1,6 +1,7 @@
 #include "texture.h"
-#include "external/glad.h"
+#include "textureStreamer.h"
 #include "external/stb_image.h"
+#include <stdio.h>
 
 static int getTextureFormat(int numComponents) {
 	switch (numComponents) {
@@ -10,10 +11,14 @@ static int getTextureFormat(int numComponents) {
 		return GL_RGB;
 	case 2:
 		return GL_RG;
+	case 1:
+		return GL_RED;
 	}
 }
 namespace ew {
 	unsigned int loadTexture(const char* filePath, int wrapMode, int filterMode) {
+		//Set every time, the flag is per thread and other loaders on this thread may have flipped
+		stbi_set_flip_vertically_on_load_thread(false);
 		int width, height, numComponents;
 		unsigned char* data = stbi_load(filePath, &width, &height, &numComponents, 0);
 		if (data == NULL) {
@@ -21,15 +26,39 @@ namespace ew {
 			stbi_image_free(data);
 			return 0;
 		}
+		TextureSettings settings;
+		settings.wrapMode = wrapMode;
+		settings.magFilter = filterMode;
+		unsigned int texture = createTexture(data, width, height, numComponents, settings);
+		stbi_image_free(data);
+		return texture;
+	}
+
+	unsigned int loadTextureAsync(const char* filePath, int wrapMode, int filterMode) {
+		TextureSettings settings;
+		settings.wrapMode = wrapMode;
+		settings.magFilter = filterMode;
+		return TextureStreamer::global().load(filePath, settings);
+	}
+
+	unsigned int createTexture(const unsigned char* pixels, int width, int height, int numComponents, const TextureSettings& settings) {
 		unsigned int texture;
 		glGenTextures(1, &texture);
+		setTextureImage(texture, pixels, width, height, numComponents, settings);
+		return texture;
+	}
+
+	void setTextureImage(unsigned int texture, const unsigned char* pixels, int width, int height, int numComponents, const TextureSettings& settings) {
 		glBindTexture(GL_TEXTURE_2D, texture);
 		int format = getTextureFormat(numComponents);
-		glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrapMode);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrapMode);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filterMode);
+		//Rows of 1 to 3 component images aren't always 4 byte aligned
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, pixels);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, settings.wrapMode);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, settings.wrapMode);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, settings.minFilter);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, settings.magFilter);
 
 		float borderColor[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
 		glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
@@ -37,8 +66,5 @@ namespace ew {
 		glGenerateMipmap(GL_TEXTURE_2D);
 
 		glBindTexture(GL_TEXTURE_2D, NULL);
-		stbi_image_free(data);
-		return texture;
 	}
 }
-
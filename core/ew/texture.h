@@ -1,5 +1,19 @@
 #pragma once
+#include "external/glad.h"
 
 namespace ew {
+	//Sampler state a texture is created with
+	struct TextureSettings {
+		int wrapMode = GL_REPEAT;
+		int minFilter = GL_LINEAR_MIPMAP_LINEAR;
+		int magFilter = GL_LINEAR;
+	};
+
 	unsigned int loadTexture(const char* filePath, int wrapMode, int filterMode);
+	//Same, but returns straight away with a placeholder. The image appears once TextureStreamer::global().update() uploads it
+	unsigned int loadTextureAsync(const char* filePath, int wrapMode, int filterMode);
+	//Uploads 8 bit pixels with 1 to 4 components and builds mipmaps. Returns the new texture
+	unsigned int createTexture(const unsigned char* pixels, int width, int height, int numComponents, const TextureSettings& settings);
+	//Same, replacing the image and sampler state of an existing texture
+	void setTextureImage(unsigned int texture, const unsigned char* pixels, int width, int height, int numComponents, const TextureSettings& settings);
 }
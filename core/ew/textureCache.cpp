@@ -0,0 +1,234 @@
+#include "textureCache.h"
+#include "external/stb_image.h"
+#include <stdio.h>
+#include <stdlib.h>
+#ifndef _WIN32
+#include <limits.h>
+#endif
+
+namespace ew {
+	static std::string settingsKey(const TextureSettings& settings)
+	{
+		return "|" + std::to_string(settings.wrapMode) + "|" + std::to_string(settings.minFilter) + "|" + std::to_string(settings.magFilter);
+	}
+
+	static std::string contentKey(uint64_t hash, const std::string& samplerKey)
+	{
+		char hex[17];
+		snprintf(hex, sizeof(hex), "%016llx", (unsigned long long)hash);
+		return hex + samplerKey;
+	}
+
+	static bool readFile(const std::string& path, std::vector<unsigned char>& out)
+	{
+		FILE* file = fopen(path.c_str(), "rb");
+		if (!file)
+			return false;
+		fseek(file, 0, SEEK_END);
+		const long size = ftell(file);
+		fseek(file, 0, SEEK_SET);
+		out.resize(size > 0 ? (size_t)size : 0);
+		const bool read = size > 0 && fread(out.data(), 1, out.size(), file) == out.size();
+		fclose(file);
+		return read;
+	}
+
+	TextureCache::~TextureCache()
+	{
+		for (const auto& entry : m_entries)
+		{
+			//Pending callbacks point back at this cache
+			if (entry.second.streamer)
+				entry.second.streamer->cancel(entry.first);
+			glDeleteTextures(1, &entry.first);
+		}
+	}
+
+	unsigned int TextureCache::acquire(const std::string& path, const TextureSettings& settings)
+	{
+		const std::string samplerKey = settingsKey(settings);
+		const std::string pathKey = CanonicalPath(path) + samplerKey;
+		auto found = m_byPath.find(pathKey);
+		if (found != m_byPath.end()) {
+			m_stats.hits++;
+			m_entries[found->second].references++;
+			return found->second;
+		}
+
+		std::vector<unsigned char> bytes;
+		if (!readFile(path, bytes)) {
+			printf("Failed to load image %s\n", path.c_str());
+			m_stats.failures++;
+			return 0;
+		}
+		const std::string contentKey = ew::contentKey(HashBytes(bytes.data(), bytes.size()), samplerKey);
+		found = m_byContent.find(contentKey);
+		if (found != m_byContent.end()) {
+			m_stats.contentHits++;
+			Entry& entry = m_entries[found->second];
+			entry.references++;
+			entry.pathKeys.push_back(pathKey);
+			m_byPath[pathKey] = found->second;
+			return found->second;
+		}
+
+		int width, height, numComponents;
+		stbi_set_flip_vertically_on_load_thread(false);
+		unsigned char* pixels = stbi_load_from_memory(bytes.data(), (int)bytes.size(), &width, &height, &numComponents, 0);
+		if (!pixels) {
+			printf("Failed to decode image %s: %s\n", path.c_str(), stbi_failure_reason());
+			m_stats.failures++;
+			return 0;
+		}
+		const unsigned int texture = createTexture(pixels, width, height, numComponents, settings);
+		stbi_image_free(pixels);
+
+		Entry& entry = m_entries[texture];
+		entry.references = 1;
+		//Each mip level is a quarter of the one above, a third more than level 0 in total
+		entry.bytes = (size_t)width * height * numComponents * 4 / 3;
+		entry.contentKey = contentKey;
+		entry.pathKeys.push_back(pathKey);
+		m_byPath[pathKey] = texture;
+		m_byContent[contentKey] = texture;
+		m_stats.misses++;
+		m_stats.textures++;
+		m_stats.bytesResident += entry.bytes;
+		return texture;
+	}
+
+	unsigned int TextureCache::acquireAsync(const std::string& path, const TextureSettings& settings, TextureStreamer& streamer)
+	{
+		const std::string samplerKey = settingsKey(settings);
+		const std::string pathKey = CanonicalPath(path) + samplerKey;
+		auto found = m_byPath.find(pathKey);
+		if (found != m_byPath.end()) {
+			m_stats.hits++;
+			m_entries[found->second].references++;
+			return found->second;
+		}
+
+		const unsigned int texture = streamer.load(path, settings, false, [this, samplerKey](const TextureStreamResult& result) {
+			streamed(result, samplerKey);
+		});
+		Entry& entry = m_entries[texture];
+		entry.references = 1;
+		entry.pathKeys.push_back(pathKey);
+		entry.streamer = &streamer;
+		m_byPath[pathKey] = texture;
+		m_stats.misses++;
+		m_stats.pending++;
+		m_stats.textures++;
+		return texture;
+	}
+
+	void TextureCache::streamed(const TextureStreamResult& result, const std::string& samplerKey)
+	{
+		Entry& entry = m_entries[result.texture];
+		entry.streamer = nullptr;
+		m_stats.pending--;
+		if (!result.loaded) {
+			m_stats.failures++;
+			return;
+		}
+		entry.bytes = (size_t)result.width * result.height * result.numComponents * 4 / 3;
+		m_stats.bytesResident += entry.bytes;
+		//Handles to it are already out, so a copy of a texture loaded under another path stays separate. Registering the
+		//content still lets later synchronous acquires of a copy share whichever came first
+		const std::string key = contentKey(result.contentHash, samplerKey);
+		if (m_byContent.emplace(key, result.texture).second)
+			entry.contentKey = key;
+	}
+
+	void TextureCache::release(unsigned int texture)
+	{
+		auto found = m_entries.find(texture);
+		if (found == m_entries.end() || --found->second.references > 0)
+			return;
+		const Entry& entry = found->second;
+		if (entry.streamer) {
+			entry.streamer->cancel(texture);
+			m_stats.pending--;
+		}
+		for (const std::string& key : entry.pathKeys)
+			m_byPath.erase(key);
+		if (!entry.contentKey.empty())
+			m_byContent.erase(entry.contentKey);
+		m_stats.textures--;
+		m_stats.bytesResident -= entry.bytes;
+		m_entries.erase(found);
+		glDeleteTextures(1, &texture);
+	}
+
+	int TextureCache::getReferenceCount(unsigned int texture)const
+	{
+		auto found = m_entries.find(texture);
+		return found == m_entries.end() ? 0 : found->second.references;
+	}
+
+	TextureCache& TextureCache::global()
+	{
+		//Streamer first, so it is destroyed after the cache, which cancels loads on it when it goes
+		TextureStreamer::global();
+		static TextureCache cache;
+		return cache;
+	}
+
+	TextureReference::TextureReference(unsigned int texture, TextureCache& cache)
+		:m_texture(texture), m_cache(&cache)
+	{
+	}
+
+	TextureReference::~TextureReference()
+	{
+		if (m_texture)
+			m_cache->release(m_texture);
+	}
+
+	TextureReference::TextureReference(TextureReference&& other) noexcept
+		:m_texture(other.m_texture), m_cache(other.m_cache)
+	{
+		other.m_texture = 0;
+	}
+
+	TextureReference& TextureReference::operator=(TextureReference&& other) noexcept
+	{
+		if (this != &other) {
+			if (m_texture)
+				m_cache->release(m_texture);
+			m_texture = other.m_texture;
+			m_cache = other.m_cache;
+			other.m_texture = 0;
+		}
+		return *this;
+	}
+
+	std::string CanonicalPath(const std::string& path)
+	{
+#ifdef _WIN32
+		char resolved[_MAX_PATH];
+		if (!_fullpath(resolved, path.c_str(), sizeof(resolved)))
+			return path;
+		//Windows paths are case insensitive and take either slash
+		std::string canonical = resolved;
+		for (char& c : canonical)
+			c = c == '\\' ? '/' : (char)tolower((unsigned char)c);
+		return canonical;
+#else
+		char resolved[PATH_MAX];
+		return realpath(path.c_str(), resolved) ? std::string(resolved) : path;
+#endif
+	}
+
+	uint64_t HashBytes(const void* data, size_t size)
+	{
+		uint64_t hash = 14695981039346656037ull;
+		const unsigned char* bytes = (const unsigned char*)data;
+		for (size_t i = 0; i < size; i++)
+		{
+			hash ^= bytes[i];
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <stdint.h>
+#include <stddef.h>
+#include "texture.h"
+#include "textureStreamer.h"
+
+namespace ew {
+	struct TextureCacheStats {
+		size_t hits = 0; //Found by path
+		size_t contentHits = 0; //New path, but the same bytes as a texture already loaded. Synchronous acquires only
+		size_t misses = 0; //Decoded and uploaded
+		size_t failures = 0; //Couldn't be read or decoded
+		size_t pending = 0; //Async loads not uploaded yet
+		size_t textures = 0; //Resident now, placeholders included
+		size_t bytesResident = 0; //Estimated GPU memory of resident textures, mip chains included
+	};
+
+	/// <summary>
+	/// Process wide cache of textures loaded from files. A file is decoded and uploaded once however many models use it:
+	/// lookups go by canonical path first, then, for acquire, by a hash of the file's bytes, so copies of an atlas under
+	/// different names share one texture too. acquireAsync dedupes by path only. Textures are reference counted and deleted
+	/// when the last reference is released.
+	/// GL context thread only.
+	/// </summary>
+	class TextureCache {
+	public:
+		TextureCache() = default;
+		~TextureCache();
+		TextureCache(const TextureCache&) = delete;
+		TextureCache& operator=(const TextureCache&) = delete;
+
+		//Takes a reference to the texture at path with these sampler settings, loading it on a miss. 0 if it can't be loaded
+		unsigned int acquire(const std::string& path, const TextureSettings& settings = TextureSettings());
+		//Same, but a miss returns streamer's placeholder straight away and the file is decoded off this thread.
+		//Dedupes by path only: the handle is given out before the file's bytes are read, so a copy of another texture under a
+		//different path is loaded and kept resident on its own. Once uploaded, later acquire calls for copies of it share it
+		unsigned int acquireAsync(const std::string& path, const TextureSettings& settings = TextureSettings(), TextureStreamer& streamer = TextureStreamer::global());
+		//Drops a reference taken by acquire. The texture is deleted with its last one
+		void release(unsigned int texture);
+		inline const TextureCacheStats& getStats()const { return m_stats; }
+		//References held to texture, 0 if it isn't in the cache
+		int getReferenceCount(unsigned int texture)const;
+
+		//Shared cache, created on first use
+		static TextureCache& global();
+	private:
+		struct Entry {
+			int references = 0;
+			size_t bytes = 0;
+			std::string contentKey;
+			std::vector<std::string> pathKeys; //Every path it was found by
+			TextureStreamer* streamer = nullptr; //Set while an async load is pending
+		};
+		void streamed(const TextureStreamResult& result, const std::string& samplerKey);
+		std::unordered_map<std::string, unsigned int> m_byPath; //Canonical path and settings to texture
+		std::unordered_map<std::string, unsigned int> m_byContent; //Content hash and settings to texture
+		std::unordered_map<unsigned int, Entry> m_entries;
+		TextureCacheStats m_stats;
+	};
+
+	/// <summary>
+	/// Owns one reference to a cached texture and releases it when destroyed. Movable, not copyable.
+	/// </summary>
+	class TextureReference {
+	public:
+		TextureReference() = default;
+		//Adopts a reference already taken with acquire
+		explicit TextureReference(unsigned int texture, TextureCache& cache = TextureCache::global());
+		~TextureReference();
+		TextureReference(TextureReference&& other) noexcept;
+		TextureReference& operator=(TextureReference&& other) noexcept;
+		TextureReference(const TextureReference&) = delete;
+		TextureReference& operator=(const TextureReference&) = delete;
+		inline unsigned int get()const { return m_texture; }
+	private:
+		unsigned int m_texture = 0;
+		TextureCache* m_cache = nullptr;
+	};
+
+	//Absolute path with . and .. resolved, so different spellings of one file match. path unchanged if it doesn't exist
+	std::string CanonicalPath(const std::string& path);
+	//64 bit FNV-1a
+	uint64_t HashBytes(const void* data, size_t size);
+}
@@ -0,0 +1,139 @@
+#include "textureStreamer.h"
+#include "textureCache.h"
+#include "external/stb_image.h"
+#include <stdio.h>
+#include <math.h>
+#include <deque>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+
+namespace ew {
+	//Mid grey, so unloaded surfaces read as untextured rather than broken
+	const unsigned char TextureStreamer::PLACEHOLDER_COLOR[4] = { 128, 128, 128, 255 };
+
+	struct TextureStreamer::Decoded {
+		unsigned int texture;
+		uint64_t serial; //Job::serial of the load that queued it
+		unsigned char* pixels; //stbi_image_free when done, NULL if decoding failed
+		int width, height, numComponents;
+		uint64_t contentHash;
+	};
+
+	struct TextureStreamer::Shared {
+		std::mutex mutex;
+		std::condition_variable decoded;
+		std::deque<Decoded> ready; //In decode order
+
+		//Images still queued when the last owner lets go, whether the streamer or a worker finishing after it
+		~Shared()
+		{
+			for (Decoded& image : ready)
+				stbi_image_free(image.pixels);
+		}
+	};
+
+	TextureStreamer::TextureStreamer(ThreadPool& pool)
+		:m_pool(pool), m_shared(std::make_shared<Shared>())
+	{
+	}
+
+	TextureStreamer::~TextureStreamer()
+	{
+		//Workers still decoding hand their images to the shared queue, freed with its last owner
+	}
+
+	unsigned int TextureStreamer::load(const std::string& path, const TextureSettings& settings, bool flipVertically,
+		std::function<void(const TextureStreamResult&)> onReady)
+	{
+		const unsigned int texture = createTexture(PLACEHOLDER_COLOR, 1, 1, 4, settings);
+		const uint64_t serial = m_nextSerial++;
+		m_jobs[texture] = { serial, settings, onReady };
+
+		std::shared_ptr<Shared> shared = m_shared;
+		m_pool.submit([shared, path, flipVertically, texture, serial]() {
+			Decoded image = { texture, serial, nullptr, 0, 0, 0, 0 };
+			FILE* file = fopen(path.c_str(), "rb");
+			if (file) {
+				fseek(file, 0, SEEK_END);
+				const long size = ftell(file);
+				fseek(file, 0, SEEK_SET);
+				std::vector<unsigned char> bytes(size > 0 ? (size_t)size : 0);
+				if (size > 0 && fread(bytes.data(), 1, bytes.size(), file) == bytes.size()) {
+					image.contentHash = HashBytes(bytes.data(), bytes.size());
+					//Per thread, so decodes running side by side can flip differently. Every decoder in core sets it before loading
+					stbi_set_flip_vertically_on_load_thread(flipVertically);
+					image.pixels = stbi_load_from_memory(bytes.data(), (int)bytes.size(), &image.width, &image.height, &image.numComponents, 0);
+				}
+				fclose(file);
+			}
+			if (!image.pixels)
+				printf("Failed to load image %s\n", path.c_str());
+			std::lock_guard<std::mutex> lock(shared->mutex);
+			shared->ready.push_back(image);
+			shared->decoded.notify_all();
+		});
+		return texture;
+	}
+
+	size_t TextureStreamer::update(float budgetMs)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		size_t finished = 0;
+		while (true)
+		{
+			Decoded image;
+			{
+				std::lock_guard<std::mutex> lock(m_shared->mutex);
+				if (m_shared->ready.empty())
+					break;
+				image = m_shared->ready.front();
+				m_shared->ready.pop_front();
+			}
+			auto job = m_jobs.find(image.texture);
+			if (job == m_jobs.end() || job->second.serial != image.serial) {
+				//Cancelled. GL reuses deleted names, so the texture may already belong to a newer load
+				stbi_image_free(image.pixels);
+				continue;
+			}
+			const TextureStreamResult result = { image.texture, image.pixels != nullptr, image.width, image.height, image.numComponents, image.contentHash };
+			if (image.pixels) {
+				setTextureImage(image.texture, image.pixels, image.width, image.height, image.numComponents, job->second.settings);
+				stbi_image_free(image.pixels);
+			}
+			std::function<void(const TextureStreamResult&)> onReady = job->second.onReady;
+			m_jobs.erase(job);
+			if (onReady)
+				onReady(result);
+			finished++;
+
+			const float elapsedMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+			if (elapsedMs >= budgetMs)
+				break;
+		}
+		return finished;
+	}
+
+	void TextureStreamer::finish()
+	{
+		while (!m_jobs.empty())
+		{
+			{
+				std::unique_lock<std::mutex> lock(m_shared->mutex);
+				m_shared->decoded.wait(lock, [this]() { return !m_shared->ready.empty(); });
+			}
+			update(INFINITY);
+		}
+	}
+
+	void TextureStreamer::cancel(unsigned int texture)
+	{
+		m_jobs.erase(texture);
+	}
+
+	TextureStreamer& TextureStreamer::global()
+	{
+		static TextureStreamer streamer;
+		return streamer;
+	}
+}
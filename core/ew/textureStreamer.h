@@ -0,0 +1,67 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <memory>
+#include <stdint.h>
+#include "texture.h"
+#include "threadPool.h"
+
+namespace ew {
+	//What a streamed texture turned into, passed to its callback on the GL thread
+	struct TextureStreamResult {
+		unsigned int texture;
+		bool loaded; //False if the file couldn't be read or decoded, the texture keeps its placeholder
+		int width, height, numComponents;
+		uint64_t contentHash; //HashBytes of the file
+	};
+
+	/// <summary>
+	/// Loads textures without stalling the render thread. load() returns a texture straight away, showing a 1x1 placeholder.
+	/// Files are read and decoded on a thread pool, then update() uploads finished images into the same texture within a
+	/// per frame time budget, so handles already given out switch to the real image without changing.
+	/// load, update and cancel are GL context thread only.
+	/// </summary>
+	class TextureStreamer {
+	public:
+		static const unsigned char PLACEHOLDER_COLOR[4];
+
+		TextureStreamer(ThreadPool& pool = ThreadPool::global());
+		~TextureStreamer();
+		TextureStreamer(const TextureStreamer&) = delete;
+		TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+		//Creates the placeholder texture and queues the decode. onReady, if given, runs in update once the image is uploaded or has failed
+		unsigned int load(const std::string& path, const TextureSettings& settings = TextureSettings(), bool flipVertically = false,
+			std::function<void(const TextureStreamResult&)> onReady = nullptr);
+		/// <summary>
+		/// Uploads decoded images until budgetMs has been spent. At least one image is uploaded if any is ready,
+		/// so a single image larger than the budget still gets through. Call once a frame.
+		/// </summary>
+		/// <returns>Number of textures finished, loaded or failed</returns>
+		size_t update(float budgetMs = 2.0f);
+		//Blocks until every queued texture is finished, for loading screens
+		void finish();
+		//Stops a pending texture from being uploaded, e.g. before deleting it. Its callback doesn't run
+		void cancel(unsigned int texture);
+		//Textures loaded but not finished yet
+		inline size_t getPending()const { return m_jobs.size(); }
+		inline bool isPending(unsigned int texture)const { return m_jobs.count(texture) > 0; }
+
+		//Shared streamer on the global thread pool, created on first use
+		static TextureStreamer& global();
+	private:
+		struct Job {
+			uint64_t serial; //Tells this load's image apart from a cancelled one whose texture name GL handed out again
+			TextureSettings settings;
+			std::function<void(const TextureStreamResult&)> onReady;
+		};
+		struct Decoded; //Image handed from a worker to update
+		struct Shared; //Queue of decoded images, outlives the streamer while workers finish
+		ThreadPool& m_pool;
+		std::shared_ptr<Shared> m_shared;
+		std::unordered_map<unsigned int, Job> m_jobs;
+		uint64_t m_nextSerial = 0;
+	};
+}
@@ -0,0 +1,104 @@
+#include "threadPool.h"
+#include <atomic>
+#include <memory>
+#include <algorithm>
+
+namespace ew {
+	ThreadPool::ThreadPool(unsigned int numThreads)
+	{
+		if (numThreads == 0)
+			numThreads = std::max(1u, std::thread::hardware_concurrency());
+		m_workers.reserve(numThreads - 1);
+		for (unsigned int i = 1; i < numThreads; i++)
+			m_workers.emplace_back(&ThreadPool::workerLoop, this);
+	}
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stopping = true;
+		}
+		m_taskAvailable.notify_all();
+		for (std::thread& worker : m_workers)
+			worker.join();
+	}
+	void ThreadPool::submit(std::function<void()> task)
+	{
+		//Single core machines get no workers, nothing would ever pick the task up
+		if (m_workers.empty())
+		{
+			task();
+			return;
+		}
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_tasks.push(std::move(task));
+		}
+		m_taskAvailable.notify_one();
+	}
+	void ThreadPool::workerLoop()
+	{
+		while (true)
+		{
+			std::function<void()> task;
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_taskAvailable.wait(lock, [this] { return m_stopping || !m_tasks.empty(); });
+				if (m_tasks.empty())
+					return;
+				task = std::move(m_tasks.front());
+				m_tasks.pop();
+			}
+			task();
+		}
+	}
+	void ThreadPool::parallelFor(size_t count, size_t minChunk, const std::function<void(size_t, size_t)>& fn)
+	{
+		minChunk = std::max(minChunk, (size_t)1);
+		if (count <= minChunk || m_workers.empty())
+		{
+			if (count > 0)
+				fn(0, count);
+			return;
+		}
+		//A few chunks per thread so uneven chunks balance out
+		const size_t numChunks = std::min((count + minChunk - 1) / minChunk, (size_t)getNumThreads() * 4);
+		const size_t chunkSize = (count + numChunks - 1) / numChunks;
+
+		//Shared so helpers that only start after the caller returned still see valid state
+		struct Job {
+			std::atomic<size_t> next{ 0 };
+			std::atomic<size_t> done{ 0 };
+			std::mutex mutex;
+			std::condition_variable finished;
+		};
+		std::shared_ptr<Job> job = std::make_shared<Job>();
+		const std::function<void(size_t, size_t)>* body = &fn;
+		auto runChunks = [job, body, count, chunkSize, numChunks]() {
+			size_t chunk;
+			while ((chunk = job->next.fetch_add(1)) < numChunks)
+			{
+				const size_t begin = chunk * chunkSize;
+				(*body)(begin, std::min(begin + chunkSize, count));
+				if (job->done.fetch_add(1) + 1 == numChunks)
+				{
+					std::lock_guard<std::mutex> lock(job->mutex);
+					job->finished.notify_all();
+				}
+			}
+		};
+
+		const size_t numHelpers = std::min((size_t)m_workers.size(), numChunks - 1);
+		for (size_t i = 0; i < numHelpers; i++)
+			submit(runChunks);
+		runChunks();
+
+		std::unique_lock<std::mutex> lock(job->mutex);
+		job->finished.wait(lock, [&job, numChunks] { return job->done.load() == numChunks; });
+	}
+	ThreadPool& ThreadPool::global()
+	{
+		static ThreadPool pool;
+		return pool;
+	}
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+namespace ew {
+	/// <summary>
+	/// Fixed set of worker threads pulling tasks from a shared queue.
+	/// parallelFor splits a range into chunks and blocks until every chunk has run. The calling thread
+	/// works on chunks too, so it is safe to call from inside another task.
+	/// </summary>
+	class ThreadPool {
+	public:
+		//numThreads counts the calling thread. 0 uses one thread per hardware core
+		explicit ThreadPool(unsigned int numThreads = 0);
+		~ThreadPool();
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		//Number of threads that run parallelFor chunks, including the caller
+		inline unsigned int getNumThreads()const { return (unsigned int)m_workers.size() + 1; }
+
+		//Runs task on a worker at some point. Does not wait, unless there are no workers and it runs right here
+		void submit(std::function<void()> task);
+
+		/// <summary>
+		/// Calls fn(begin, end) over disjoint ranges covering [0, count) and returns once all have finished.
+		/// </summary>
+		/// <param name="minChunk">Smallest range handed out. Ranges this small run inline without touching the workers</param>
+		void parallelFor(size_t count, size_t minChunk, const std::function<void(size_t begin, size_t end)>& fn);
+
+		//Shared pool sized to the machine, created on first use
+		static ThreadPool& global();
+	private:
+		void workerLoop();
+
+		std::vector<std::thread> m_workers;
+		std::queue<std::function<void()>> m_tasks;
+		std::mutex m_mutex;
+		std::condition_variable m_taskAvailable;
+		bool m_stopping = false;
+	};
+}
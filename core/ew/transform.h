@@ -2,17 +2,23 @@
 #include "ewMath/ewMath.h"
 #include "ewMath/transformations.h"
 namespace ew {
+	enum class RotationMode {
+		EULER = 0, //Uses rotation
+		QUATERNION = 1 //Uses orientation
+	};
+
 	struct Transform {
 		ew::Vec3 position = ew::Vec3(0.0f, 0.0f, 0.0f);
 		ew::Vec3 rotation = ew::Vec3(0.0f, 0.0f, 0.0f); //Euler angles (Degrees)
+		ew::Quat orientation = ew::Quat(); //Unit quaternion, used in QUATERNION mode
 		ew::Vec3 scale = ew::Vec3(1.0f, 1.0f, 1.0f);
+		RotationMode rotationMode = RotationMode::EULER;
 
 		ew::Mat4 getModelMatrix() const {
-			return ew::Translate(position)
-				* ew::RotateY(ew::Radians(rotation.y))
-				* ew::RotateX(ew::Radians(rotation.x))
-				* ew::RotateZ(ew::Radians(rotation.z))
-				* ew::Scale(scale);
+			if (rotationMode == RotationMode::QUATERNION) {
+				return ew::TRS(position, orientation, scale);
+			}
+			return ew::TRS(position, rotation * ew::DEG2RAD, scale);
 		}
 	};
 }
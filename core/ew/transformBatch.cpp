@@ -0,0 +1,114 @@
+#include "transformBatch.h"
+#include "ewMath/simd.h"
+#include "ewMath/trig.h"
+
+namespace ew {
+	void TransformBatch::resize(size_t count)
+	{
+		positionX.resize(count, 0.0f); positionY.resize(count, 0.0f); positionZ.resize(count, 0.0f);
+		rotationX.resize(count, 0.0f); rotationY.resize(count, 0.0f); rotationZ.resize(count, 0.0f);
+		orientationX.resize(count, 0.0f); orientationY.resize(count, 0.0f); orientationZ.resize(count, 0.0f); orientationW.resize(count, 1.0f);
+		scaleX.resize(count, 1.0f); scaleY.resize(count, 1.0f); scaleZ.resize(count, 1.0f);
+		rotationMode.resize(count, ew::RotationMode::EULER);
+	}
+	void TransformBatch::reserve(size_t count)
+	{
+		positionX.reserve(count); positionY.reserve(count); positionZ.reserve(count);
+		rotationX.reserve(count); rotationY.reserve(count); rotationZ.reserve(count);
+		orientationX.reserve(count); orientationY.reserve(count); orientationZ.reserve(count); orientationW.reserve(count);
+		scaleX.reserve(count); scaleY.reserve(count); scaleZ.reserve(count);
+		rotationMode.reserve(count);
+	}
+	void TransformBatch::push_back(const ew::Transform& transform)
+	{
+		resize(size() + 1);
+		set(size() - 1, transform);
+	}
+	void TransformBatch::set(size_t i, const ew::Transform& transform)
+	{
+		positionX[i] = transform.position.x; positionY[i] = transform.position.y; positionZ[i] = transform.position.z;
+		rotationX[i] = transform.rotation.x; rotationY[i] = transform.rotation.y; rotationZ[i] = transform.rotation.z;
+		orientationX[i] = transform.orientation.x; orientationY[i] = transform.orientation.y; orientationZ[i] = transform.orientation.z; orientationW[i] = transform.orientation.w;
+		scaleX[i] = transform.scale.x; scaleY[i] = transform.scale.y; scaleZ[i] = transform.scale.z;
+		rotationMode[i] = transform.rotationMode;
+	}
+	ew::Transform TransformBatch::get(size_t i) const
+	{
+		ew::Transform transform;
+		transform.position = ew::Vec3(positionX[i], positionY[i], positionZ[i]);
+		transform.rotation = ew::Vec3(rotationX[i], rotationY[i], rotationZ[i]);
+		transform.orientation = ew::Quat(orientationX[i], orientationY[i], orientationZ[i], orientationW[i]);
+		transform.scale = ew::Vec3(scaleX[i], scaleY[i], scaleZ[i]);
+		transform.rotationMode = rotationMode[i];
+		return transform;
+	}
+	/// <summary>
+	/// Same closed form as ew::TRS, evaluated for 4 transforms per iteration.
+	/// Transforms in QUATERNION mode are overwritten with their own getModelMatrix() after their block.
+	/// </summary>
+	/// <param name="out">Destination for size() matrices</param>
+	void TransformBatch::computeModelMatrices(ew::Mat4* out) const
+	{
+		const size_t count = size();
+		const size_t blockEnd = count - count % 4;
+		for (size_t i = 0; i < blockEnd; i += 4)
+		{
+			const simd::f4 toRad = simd::Splat(DEG2RAD);
+			simd::f4 sx, cx, sy, cy, sz, cz;
+			simd::SinCos(simd::Mul(simd::Load(&rotationX[i]), toRad), sx, cx);
+			simd::SinCos(simd::Mul(simd::Load(&rotationY[i]), toRad), sy, cy);
+			simd::SinCos(simd::Mul(simd::Load(&rotationZ[i]), toRad), sz, cz);
+			const simd::f4 scx = simd::Load(&scaleX[i]);
+			const simd::f4 scy = simd::Load(&scaleY[i]);
+			const simd::f4 scz = simd::Load(&scaleZ[i]);
+			const simd::f4 sysx = simd::Mul(sy, sx);
+			const simd::f4 cysx = simd::Mul(cy, sx);
+			const simd::f4 zero = simd::Splat(0.0f);
+
+			//Each register holds one matrix element for 4 transforms
+			simd::f4 c0x = simd::Mul(simd::MulAdd(sysx, sz, simd::Mul(cy, cz)), scx);
+			simd::f4 c0y = simd::Mul(simd::Mul(cx, sz), scx);
+			simd::f4 c0z = simd::Mul(simd::Sub(simd::Mul(cysx, sz), simd::Mul(sy, cz)), scx);
+			simd::f4 c0w = zero;
+			simd::f4 c1x = simd::Mul(simd::Sub(simd::Mul(sysx, cz), simd::Mul(cy, sz)), scy);
+			simd::f4 c1y = simd::Mul(simd::Mul(cx, cz), scy);
+			simd::f4 c1z = simd::Mul(simd::MulAdd(cysx, cz, simd::Mul(sy, sz)), scy);
+			simd::f4 c1w = zero;
+			simd::f4 c2x = simd::Mul(simd::Mul(sy, cx), scz);
+			simd::f4 c2y = simd::Mul(simd::Sub(zero, sx), scz);
+			simd::f4 c2z = simd::Mul(simd::Mul(cy, cx), scz);
+			simd::f4 c2w = zero;
+			simd::f4 c3x = simd::Load(&positionX[i]);
+			simd::f4 c3y = simd::Load(&positionY[i]);
+			simd::f4 c3z = simd::Load(&positionZ[i]);
+			simd::f4 c3w = simd::Splat(1.0f);
+
+			//Transpose to one column per transform
+			simd::Transpose(c0x, c0y, c0z, c0w);
+			simd::Transpose(c1x, c1y, c1z, c1w);
+			simd::Transpose(c2x, c2y, c2z, c2w);
+			simd::Transpose(c3x, c3y, c3z, c3w);
+			simd::StoreAligned(&out[i + 0][0].x, c0x); simd::StoreAligned(&out[i + 0][1].x, c1x); simd::StoreAligned(&out[i + 0][2].x, c2x); simd::StoreAligned(&out[i + 0][3].x, c3x);
+			simd::StoreAligned(&out[i + 1][0].x, c0y); simd::StoreAligned(&out[i + 1][1].x, c1y); simd::StoreAligned(&out[i + 1][2].x, c2y); simd::StoreAligned(&out[i + 1][3].x, c3y);
+			simd::StoreAligned(&out[i + 2][0].x, c0z); simd::StoreAligned(&out[i + 2][1].x, c1z); simd::StoreAligned(&out[i + 2][2].x, c2z); simd::StoreAligned(&out[i + 2][3].x, c3z);
+			simd::StoreAligned(&out[i + 3][0].x, c0w); simd::StoreAligned(&out[i + 3][1].x, c1w); simd::StoreAligned(&out[i + 3][2].x, c2w); simd::StoreAligned(&out[i + 3][3].x, c3w);
+
+			for (size_t j = i; j < i + 4; j++)
+			{
+				if (rotationMode[j] == ew::RotationMode::QUATERNION)
+					out[j] = get(j).getModelMatrix();
+			}
+		}
+		//Remainder
+		for (size_t i = blockEnd; i < count; i++)
+		{
+			out[i] = get(i).getModelMatrix();
+		}
+	}
+	void TransformBatch::computeModelMatrices(std::vector<ew::Mat4>& out) const
+	{
+		out.resize(size());
+		if (!out.empty())
+			computeModelMatrices(out.data());
+	}
+}
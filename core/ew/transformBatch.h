@@ -0,0 +1,27 @@
+#pragma once
+#include <vector>
+#include "transform.h"
+
+namespace ew {
+	//Many transforms stored as structure of arrays so model matrices can be built 4 at a time.
+	//Both rotation modes are kept. Euler transforms take the SIMD path, QUATERNION ones are built with ew::TRS afterwards,
+	//so batches that are mostly quaternions gain little.
+	struct TransformBatch {
+		std::vector<float> positionX, positionY, positionZ;
+		std::vector<float> rotationX, rotationY, rotationZ; //Euler angles (Degrees)
+		std::vector<float> orientationX, orientationY, orientationZ, orientationW; //Unit quaternion, used in QUATERNION mode
+		std::vector<float> scaleX, scaleY, scaleZ;
+		std::vector<ew::RotationMode> rotationMode;
+
+		inline size_t size()const { return positionX.size(); }
+		void resize(size_t count);
+		void reserve(size_t count);
+		void push_back(const ew::Transform& transform);
+		void set(size_t i, const ew::Transform& transform);
+		ew::Transform get(size_t i)const;
+
+		//Writes size() model matrices to out, contiguous and ready for buffer upload
+		void computeModelMatrices(ew::Mat4* out)const;
+		void computeModelMatrices(std::vector<ew::Mat4>& out)const;
+	};
+}
@@ -0,0 +1,67 @@
+#include "transformHierarchy.h"
+#include <assert.h>
+#include <algorithm>
+
+namespace ew {
+	int TransformHierarchy::add(const ew::Mat4& local, int parent)
+	{
+		assert(parent >= NO_PARENT && parent < (int)size());
+		const int node = (int)size();
+		parents.push_back(parent);
+		locals.push_back(local);
+		worlds.push_back(local);
+		dirty.push_back(1);
+		firstDirty = std::min(firstDirty, (size_t)node);
+		return node;
+	}
+	int TransformHierarchy::add(const ew::Transform& local, int parent)
+	{
+		return add(local.getModelMatrix(), parent);
+	}
+	void TransformHierarchy::reserve(size_t count)
+	{
+		parents.reserve(count);
+		locals.reserve(count);
+		worlds.reserve(count);
+		dirty.reserve(count);
+	}
+	void TransformHierarchy::clear()
+	{
+		parents.clear();
+		locals.clear();
+		worlds.clear();
+		dirty.clear();
+		firstDirty = 0;
+	}
+	void TransformHierarchy::setLocal(int node, const ew::Mat4& local)
+	{
+		locals[node] = local;
+		dirty[node] = 1;
+		firstDirty = std::min(firstDirty, (size_t)node);
+	}
+	void TransformHierarchy::setLocal(int node, const ew::Transform& local)
+	{
+		setLocal(node, local.getModelMatrix());
+	}
+	size_t TransformHierarchy::update()
+	{
+		const size_t count = size();
+		if (firstDirty >= count)
+			return 0;
+		//Parents come first, so by the time a node is visited its parent's dirty flag and world matrix are final
+		size_t updated = 0;
+		for (size_t i = firstDirty; i < count; i++)
+		{
+			const int parent = parents[i];
+			if (parent != NO_PARENT && dirty[parent])
+				dirty[i] = 1;
+			if (!dirty[i])
+				continue;
+			worlds[i] = parent == NO_PARENT ? locals[i] : worlds[parent] * locals[i];
+			updated++;
+		}
+		std::fill(dirty.begin() + firstDirty, dirty.end(), (unsigned char)0);
+		firstDirty = count;
+		return updated;
+	}
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <vector>
+#include "transform.h"
+
+namespace ew {
+	/// <summary>
+	/// Flat, parent indexed transform hierarchy. A node can only be parented to an earlier node, so
+	/// parents always come before their children and world matrices resolve in one forward pass.
+	/// World matrices are cached and only recomputed for nodes whose local matrix (or an ancestor's) changed.
+	/// </summary>
+	class TransformHierarchy {
+	public:
+		static const int NO_PARENT = -1;
+
+		//Returns the index of the new node. parent must be NO_PARENT or an existing node
+		int add(const ew::Mat4& local, int parent = NO_PARENT);
+		int add(const ew::Transform& local, int parent = NO_PARENT);
+		void reserve(size_t count);
+		void clear();
+
+		//Marks node and everything below it dirty
+		void setLocal(int node, const ew::Mat4& local);
+		void setLocal(int node, const ew::Transform& local);
+
+		inline size_t size()const { return parents.size(); }
+		inline int getParent(int node)const { return parents[node]; }
+		inline const ew::Mat4& getLocal(int node)const { return locals[node]; }
+		//Valid after update()
+		inline const ew::Mat4& getWorld(int node)const { return worlds[node]; }
+		//Contiguous world matrices of all nodes, valid after update()
+		inline const ew::Mat4* getWorldMatrices()const { return worlds.data(); }
+		inline bool isDirty()const { return firstDirty < size(); }
+
+		/// <summary>
+		/// Recomputes world matrices of dirty nodes and their descendants. Does nothing if no node changed.
+		/// </summary>
+		/// <returns>Number of world matrices recomputed</returns>
+		size_t update();
+	private:
+		std::vector<int> parents;
+		std::vector<ew::Mat4> locals;
+		std::vector<ew::Mat4> worlds;
+		std::vector<unsigned char> dirty;
+		size_t firstDirty = 0; //Nodes before this are clean, == size() when nothing needs updating
+	};
+}
@@ -0,0 +1,149 @@
+#include "vertexPacking.h"
+#include "ewMath/transformations.h"
+#include <string.h>
+#include <math.h>
+
+namespace ew {
+	uint16_t FloatToHalf(float f)
+	{
+		uint32_t x;
+		memcpy(&x, &f, sizeof(x));
+		const uint32_t sign = (x >> 16) & 0x8000;
+		const uint32_t absX = x & 0x7FFFFFFF;
+		//NaN stays NaN, anything too big for a half becomes infinity
+		if (absX > 0x7F800000)
+			return (uint16_t)(sign | 0x7E00);
+		if (absX >= 0x477FF000)
+			return (uint16_t)(sign | 0x7C00);
+		//Too small for a normal half, round to a denormal
+		if (absX < 0x38800000) {
+			float absF;
+			memcpy(&absF, &absX, sizeof(absF));
+			return (uint16_t)(sign | (uint32_t)lrintf(absF * 16777216.0f)); //2^24, the denormal step
+		}
+		//Rebias exponent and round to nearest even on the dropped 13 mantissa bits
+		const uint32_t rebiased = absX - 0x38000000;
+		const uint32_t rounded = rebiased + 0x0FFF + ((rebiased >> 13) & 1);
+		return (uint16_t)(sign | (rounded >> 13));
+	}
+	float HalfToFloat(uint16_t h)
+	{
+		const uint32_t sign = (uint32_t)(h & 0x8000) << 16;
+		const uint32_t exponent = (h >> 10) & 0x1F;
+		const uint32_t mantissa = h & 0x3FF;
+		float f;
+		if (exponent == 0) {
+			f = mantissa / 16777216.0f;
+			return sign ? -f : f;
+		}
+		uint32_t x;
+		if (exponent == 31)
+			x = sign | 0x7F800000 | (mantissa << 13);
+		else
+			x = sign | ((exponent + 112) << 23) | (mantissa << 13);
+		memcpy(&f, &x, sizeof(f));
+		return f;
+	}
+	int16_t PackSnorm16(float f)
+	{
+		f = fminf(fmaxf(f, -1.0f), 1.0f);
+		return (int16_t)lrintf(f * 32767.0f);
+	}
+	float UnpackSnorm16(int16_t v)
+	{
+		return fmaxf(v / 32767.0f, -1.0f);
+	}
+	static uint32_t packSnorm10(float f)
+	{
+		f = fminf(fmaxf(f, -1.0f), 1.0f);
+		return (uint32_t)lrintf(f * 511.0f) & 0x3FF;
+	}
+	static float unpackSnorm10(uint32_t v)
+	{
+		//Sign extend from 10 bits
+		const int32_t s = (int32_t)(v << 22) >> 22;
+		return fmaxf(s / 511.0f, -1.0f);
+	}
+	uint32_t PackNormal1010102(const ew::Vec3& n)
+	{
+		return packSnorm10(n.x) | (packSnorm10(n.y) << 10) | (packSnorm10(n.z) << 20);
+	}
+	ew::Vec3 UnpackNormal1010102(uint32_t packed)
+	{
+		return ew::Vec3(unpackSnorm10(packed), unpackSnorm10(packed >> 10), unpackSnorm10(packed >> 20));
+	}
+
+	ew::Mat4 PackingBounds::dequantizeMatrix() const
+	{
+		return ew::Translate(center) * ew::Scale(extents);
+	}
+	PackingBounds ComputePackingBounds(const Vertex* vertices, size_t count)
+	{
+		if (count == 0)
+			return { ew::Vec3(0.0f), ew::Vec3(1.0f) };
+		ew::Vec3 min = vertices[0].pos, max = vertices[0].pos;
+		for (size_t i = 1; i < count; i++)
+		{
+			const ew::Vec3& p = vertices[i].pos;
+			min = ew::Vec3(fminf(min.x, p.x), fminf(min.y, p.y), fminf(min.z, p.z));
+			max = ew::Vec3(fmaxf(max.x, p.x), fmaxf(max.y, p.y), fmaxf(max.z, p.z));
+		}
+		PackingBounds bounds;
+		bounds.center = (min + max) * 0.5f;
+		bounds.extents = (max - min) * 0.5f;
+		//Flat axes (e.g. a plane) still need a non zero scale to divide by
+		bounds.extents = ew::Vec3(fmaxf(bounds.extents.x, 1e-6f), fmaxf(bounds.extents.y, 1e-6f), fmaxf(bounds.extents.z, 1e-6f));
+		return bounds;
+	}
+	void PackVertices(const Vertex* vertices, size_t count, const PackingBounds& bounds, PackedVertex* out)
+	{
+		const ew::Vec3 invExtents = ew::Vec3(1.0f / bounds.extents.x, 1.0f / bounds.extents.y, 1.0f / bounds.extents.z);
+		for (size_t i = 0; i < count; i++)
+		{
+			const Vertex& v = vertices[i];
+			PackedVertex packed;
+			packed.pos[0] = PackSnorm16((v.pos.x - bounds.center.x) * invExtents.x);
+			packed.pos[1] = PackSnorm16((v.pos.y - bounds.center.y) * invExtents.y);
+			packed.pos[2] = PackSnorm16((v.pos.z - bounds.center.z) * invExtents.z);
+			packed.pos[3] = 0;
+			packed.normal = PackNormal1010102(v.normal);
+			packed.uv[0] = FloatToHalf(v.uv.x);
+			packed.uv[1] = FloatToHalf(v.uv.y);
+			out[i] = packed;
+		}
+	}
+	Vertex UnpackVertex(const PackedVertex& v, const PackingBounds& bounds)
+	{
+		Vertex out;
+		out.pos = ew::Vec3(
+			bounds.center.x + UnpackSnorm16(v.pos[0]) * bounds.extents.x,
+			bounds.center.y + UnpackSnorm16(v.pos[1]) * bounds.extents.y,
+			bounds.center.z + UnpackSnorm16(v.pos[2]) * bounds.extents.z);
+		out.normal = UnpackNormal1010102(v.normal);
+		out.uv = ew::Vec2(HalfToFloat(v.uv[0]), HalfToFloat(v.uv[1]));
+		return out;
+	}
+	PackingError MeasurePackingError(const Vertex* vertices, size_t count)
+	{
+		PackingError error = { 0.0f, 0.0f, 0.0f };
+		const PackingBounds bounds = ComputePackingBounds(vertices, count);
+		for (size_t i = 0; i < count; i++)
+		{
+			PackedVertex packed;
+			PackVertices(vertices + i, 1, bounds, &packed);
+			const Vertex v = UnpackVertex(packed, bounds);
+			const Vertex& original = vertices[i];
+
+			error.position = fmaxf(error.position, ew::Magnitude(v.pos - original.pos));
+			//Compare directions, the shader normalizes after unpacking
+			const float originalLength = ew::Magnitude(original.normal);
+			const float unpackedLength = ew::Magnitude(v.normal);
+			if (originalLength > 0 && unpackedLength > 0) {
+				const float cosAngle = fminf(fmaxf(ew::Dot(original.normal, v.normal) / (originalLength * unpackedLength), -1.0f), 1.0f);
+				error.normalDegrees = fmaxf(error.normalDegrees, acosf(cosAngle) * ew::RAD2DEG);
+			}
+			error.uv = fmaxf(error.uv, fmaxf(fabsf(v.uv.x - original.uv.x), fabsf(v.uv.y - original.uv.y)));
+		}
+		return error;
+	}
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include "mesh.h"
+
+namespace ew {
+	/// <summary>
+	/// 16 byte vertex. Positions are snorm16 relative to the mesh bounds (see dequantizeMatrix),
+	/// normals are snorm 10:10:10:2 and UVs are half floats.
+	/// </summary>
+	struct PackedVertex {
+		int16_t pos[4]; //xyz, w unused
+		uint32_t normal; //GL_INT_2_10_10_10_REV, w unused
+		uint16_t uv[2]; //GL_HALF_FLOAT
+	};
+
+	//Scalar conversions
+	uint16_t FloatToHalf(float f);
+	float HalfToFloat(uint16_t h);
+	int16_t PackSnorm16(float f);
+	float UnpackSnorm16(int16_t v);
+	uint32_t PackNormal1010102(const ew::Vec3& n);
+	ew::Vec3 UnpackNormal1010102(uint32_t packed);
+
+	//Maps packed snorm positions in [-1,1] back to model space: Translate(center) * Scale(extents)
+	struct PackingBounds {
+		ew::Vec3 center;
+		ew::Vec3 extents;
+		ew::Mat4 dequantizeMatrix()const;
+	};
+	PackingBounds ComputePackingBounds(const Vertex* vertices, size_t count);
+
+	//out must have room for count vertices
+	void PackVertices(const Vertex* vertices, size_t count, const PackingBounds& bounds, PackedVertex* out);
+	Vertex UnpackVertex(const PackedVertex& v, const PackingBounds& bounds);
+
+	//Largest difference between the original and round tripped attributes of a mesh
+	struct PackingError {
+		float position; //Model space distance
+		float normalDegrees; //Angle between normals
+		float uv;
+	};
+	PackingError MeasurePackingError(const Vertex* vertices, size_t count);
+}
@@ -0,0 +1,113 @@
+#include "vertexWeld.h"
+#include <unordered_map>
+#include <vector>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+namespace ew {
+	static const unsigned int NONE = 0xFFFFFFFF;
+
+	static uint64_t cellKey(int64_t x, int64_t y, int64_t z) {
+		//21 bits per axis is plenty for any sane mesh / tolerance ratio, wrapping only costs extra comparisons
+		return ((uint64_t)(x & 0x1FFFFF) << 42) | ((uint64_t)(y & 0x1FFFFF) << 21) | (uint64_t)(z & 0x1FFFFF);
+	}
+
+	static bool within(const float* a, const float* b, int count, float tolerance) {
+		for (int i = 0; i < count; i++)
+		{
+			if (!(fabsf(a[i] - b[i]) <= tolerance))
+				return false;
+		}
+		return true;
+	}
+
+	WeldStats WeldVertices(void* vertices, size_t vertexCount, const WeldLayout& layout, unsigned int* indices, size_t indexCount, const WeldTolerances& tolerances)
+	{
+		unsigned char* bytes = (unsigned char*)vertices;
+		auto attribute = [&](size_t v, size_t offset) { return (const float*)(bytes + v * layout.stride + offset); };
+
+		//Cells are one position tolerance wide, so a match is always in the same or an adjacent cell.
+		//With no tolerance the cell is the exact position and only that cell is searched
+		const bool exact = tolerances.position <= 0;
+		const float invCell = exact ? 0.0f : 1.0f / tolerances.position;
+		auto cellOf = [&](const float* p, int64_t cell[3]) {
+			for (int k = 0; k < 3; k++)
+			{
+				if (exact) {
+					uint32_t bits;
+					const float f = p[k] == 0.0f ? 0.0f : p[k]; //-0 == 0
+					memcpy(&bits, &f, sizeof(bits));
+					cell[k] = bits;
+				}
+				else {
+					cell[k] = (int64_t)floorf(p[k] * invCell);
+				}
+			}
+		};
+
+		std::unordered_map<uint64_t, unsigned int> cellHead; //First welded vertex in each cell
+		cellHead.reserve(vertexCount);
+		std::vector<unsigned int> nextInCell;
+		nextInCell.reserve(vertexCount);
+		std::vector<unsigned int> remap(vertexCount);
+		size_t welded = 0;
+
+		const int reach = exact ? 0 : 1;
+		for (size_t v = 0; v < vertexCount; v++)
+		{
+			const float* position = attribute(v, layout.positionOffset);
+			const float* normal = attribute(v, layout.normalOffset);
+			const float* uv = attribute(v, layout.uvOffset);
+			int64_t cell[3];
+			cellOf(position, cell);
+
+			unsigned int match = NONE;
+			for (int dx = -reach; dx <= reach && match == NONE; dx++)
+				for (int dy = -reach; dy <= reach && match == NONE; dy++)
+					for (int dz = -reach; dz <= reach && match == NONE; dz++)
+					{
+						auto head = cellHead.find(cellKey(cell[0] + dx, cell[1] + dy, cell[2] + dz));
+						if (head == cellHead.end())
+							continue;
+						for (unsigned int w = head->second; w != NONE; w = nextInCell[w])
+						{
+							if (within(position, attribute(w, layout.positionOffset), 3, tolerances.position)
+								&& within(normal, attribute(w, layout.normalOffset), 3, tolerances.normal)
+								&& within(uv, attribute(w, layout.uvOffset), 2, tolerances.uv)) {
+								match = w;
+								break;
+							}
+						}
+					}
+			if (match != NONE) {
+				remap[v] = match;
+				continue;
+			}
+			//New vertex. Moving it forward is safe, everything before welded has already been read
+			if (welded != v)
+				memcpy(bytes + welded * layout.stride, bytes + v * layout.stride, layout.stride);
+			const uint64_t key = cellKey(cell[0], cell[1], cell[2]);
+			auto head = cellHead.find(key);
+			nextInCell.push_back(head == cellHead.end() ? NONE : head->second);
+			cellHead[key] = (unsigned int)welded;
+			remap[v] = (unsigned int)welded++;
+		}
+
+		for (size_t i = 0; i < indexCount; i++)
+			indices[i] = remap[indices[i]];
+
+		WeldStats stats;
+		stats.verticesBefore = vertexCount;
+		stats.verticesAfter = welded;
+		return stats;
+	}
+
+	WeldStats WeldVertices(MeshData& mesh, const WeldTolerances& tolerances)
+	{
+		const WeldLayout layout = { sizeof(Vertex), offsetof(Vertex, pos), offsetof(Vertex, normal), offsetof(Vertex, uv) };
+		WeldStats stats = WeldVertices(mesh.vertices.data(), mesh.vertices.size(), layout, mesh.indices.data(), mesh.indices.size(), tolerances);
+		mesh.vertices.resize(stats.verticesAfter);
+		return stats;
+	}
+}
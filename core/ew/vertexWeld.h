@@ -0,0 +1,37 @@
+#pragma once
+#include <stddef.h>
+#include "mesh.h"
+
+namespace ew {
+	//Largest per component difference at which two vertices are merged. 0 only merges exact matches
+	struct WeldTolerances {
+		float position = 1e-5f;
+		float normal = 1e-3f;
+		float uv = 1e-5f;
+	};
+
+	//Byte offsets of a float xyz position, float xyz normal and float uv inside a vertex of stride bytes
+	struct WeldLayout {
+		size_t stride;
+		size_t positionOffset;
+		size_t normalOffset;
+		size_t uvOffset;
+	};
+
+	struct WeldStats {
+		size_t verticesBefore = 0;
+		size_t verticesAfter = 0;
+		//How many times smaller the vertex buffer got
+		inline float reduction()const { return verticesAfter > 0 ? (float)verticesBefore / verticesAfter : 1.0f; }
+	};
+
+	/// <summary>
+	/// Merges vertices whose attributes are all within tolerance of an earlier vertex, using a spatial hash of positions.
+	/// Survivors are compacted to the front of vertices in their original order and indices are rewritten to match.
+	/// </summary>
+	/// <returns>Vertex counts before and after</returns>
+	WeldStats WeldVertices(void* vertices, size_t vertexCount, const WeldLayout& layout, unsigned int* indices, size_t indexCount,
+		const WeldTolerances& tolerances = WeldTolerances());
+	//Resizes mesh.vertices to the welded count
+	WeldStats WeldVertices(MeshData& mesh, const WeldTolerances& tolerances = WeldTolerances());
+}
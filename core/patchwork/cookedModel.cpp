@@ -0,0 +1,287 @@
+#include "cookedModel.h"
+#include <stdio.h>
+#include <string.h>
+
+namespace patchwork
+{
+    static const size_t COOKED_ALIGNMENT = 16;
+
+    //Appends to a byte vector, returning offsets so headers written earlier can be patched
+    class CookedWriter
+    {
+    public:
+        std::vector<unsigned char> bytes;
+
+        size_t align()
+        {
+            bytes.resize((bytes.size() + COOKED_ALIGNMENT - 1) / COOKED_ALIGNMENT * COOKED_ALIGNMENT, 0);
+            return bytes.size();
+        }
+        size_t write(const void* data, size_t size)
+        {
+            const size_t offset = bytes.size();
+            bytes.insert(bytes.end(), (const unsigned char*)data, (const unsigned char*)data + size);
+            return offset;
+        }
+        size_t reserve(size_t size)
+        {
+            const size_t offset = align();
+            bytes.resize(offset + size, 0);
+            return offset;
+        }
+        template <typename T>
+        T* at(size_t offset) { return (T*)(bytes.data() + offset); }
+    };
+
+    bool WriteCookedModel(const std::string& path, const ImportedModel& model)
+    {
+        CookedWriter writer;
+        const size_t headerOffset = writer.reserve(sizeof(CookedHeader));
+        {
+            CookedHeader* header = writer.at<CookedHeader>(headerOffset);
+            memcpy(header->magic, COOKED_MODEL_MAGIC, sizeof(header->magic));
+            header->version = COOKED_MODEL_VERSION;
+            header->vertexSize = sizeof(Vertex);
+            header->meshCount = (uint32_t)model.meshes.size();
+            header->nodeCount = (uint32_t)model.nodeLocals.size();
+            header->verticesBeforeWeld = model.weldStats.verticesBefore;
+            header->verticesAfterWeld = model.weldStats.verticesAfter;
+        }
+
+        const size_t nodesOffset = writer.reserve(sizeof(CookedNode) * model.nodeLocals.size());
+        for (size_t i = 0; i < model.nodeLocals.size(); i++)
+        {
+            CookedNode* node = writer.at<CookedNode>(nodesOffset) + i;
+            memcpy(node->local, &model.nodeLocals[i], sizeof(node->local));
+            node->parent = model.nodeParents[i];
+        }
+        const size_t meshesOffset = writer.reserve(sizeof(CookedMesh) * model.meshes.size());
+        writer.at<CookedHeader>(headerOffset)->nodesOffset = nodesOffset;
+        writer.at<CookedHeader>(headerOffset)->meshesOffset = meshesOffset;
+
+        std::vector<unsigned char> indexData;
+        for (size_t m = 0; m < model.meshes.size(); m++)
+        {
+            const ImportedMesh& mesh = model.meshes[m];
+            //The same narrowing Mesh does at upload, done once here
+            const ew::IndexBufferLayout layout = ew::buildIndexBuffer(mesh.indices.data(), mesh.indices.size(), mesh.vertices.size(), indexData);
+            CookedMesh cooked = {};
+            cooked.vertexCount = (uint32_t)mesh.vertices.size();
+            cooked.indexType = (uint32_t)layout.type;
+            cooked.node = mesh.node;
+            memcpy(cooked.boundsMin, &mesh.bounds.min, sizeof(cooked.boundsMin));
+            memcpy(cooked.boundsMax, &mesh.bounds.max, sizeof(cooked.boundsMax));
+
+            writer.align();
+            cooked.verticesOffset = writer.write(mesh.vertices.data(), mesh.vertices.size() * sizeof(Vertex));
+            writer.align();
+            cooked.indicesOffset = writer.write(indexData.data(), indexData.size());
+            cooked.indexBytes = indexData.size();
+            cooked.indexCount = (uint32_t)(indexData.size() / layout.indexSize()); //Trailing indices short of a triangle are dropped
+
+            writer.align();
+            cooked.chunksOffset = writer.bytes.size();
+            cooked.chunkCount = (uint32_t)layout.chunks.size();
+            for (const ew::IndexChunk& chunk : layout.chunks)
+            {
+                const CookedIndexChunk c = { (uint32_t)chunk.firstIndex, (uint32_t)chunk.count, chunk.baseVertex, 0 };
+                writer.write(&c, sizeof(c));
+            }
+            cooked.lodsOffset = writer.bytes.size();
+            cooked.lodCount = (uint32_t)mesh.lods.size();
+            for (const ew::LodLevel& lod : mesh.lods)
+            {
+                const CookedLod l = { (uint32_t)lod.firstIndex, (uint32_t)lod.indexCount, lod.error, 0 };
+                writer.write(&l, sizeof(l));
+            }
+            cooked.meshletsOffset = writer.bytes.size();
+            cooked.meshletCount = (uint32_t)mesh.meshlets.size();
+            for (const ew::Meshlet& meshlet : mesh.meshlets)
+            {
+                const CookedMeshlet c = { (uint32_t)meshlet.firstIndex, (uint32_t)meshlet.indexCount, (uint32_t)meshlet.vertexCount,
+                    { meshlet.bounds.center.x, meshlet.bounds.center.y, meshlet.bounds.center.z }, meshlet.bounds.radius,
+                    { meshlet.coneAxis.x, meshlet.coneAxis.y, meshlet.coneAxis.z }, meshlet.coneSin, meshlet.coneCos };
+                writer.write(&c, sizeof(c));
+            }
+            cooked.texturesOffset = writer.bytes.size();
+            cooked.textureCount = (uint32_t)mesh.textures.size();
+            for (const TextureRef& texture : mesh.textures)
+            {
+                const uint32_t lengths[2] = { (uint32_t)texture.type.size(), (uint32_t)texture.path.size() };
+                writer.write(lengths, sizeof(lengths));
+                writer.write(texture.type.data(), texture.type.size());
+                writer.write(texture.path.data(), texture.path.size());
+            }
+            memcpy(writer.at<CookedMesh>(meshesOffset) + m, &cooked, sizeof(cooked));
+        }
+
+        FILE* file = fopen(path.c_str(), "wb");
+        if (!file) {
+            printf("Failed to open %s for writing\n", path.c_str());
+            return false;
+        }
+        const bool written = fwrite(writer.bytes.data(), 1, writer.bytes.size(), file) == writer.bytes.size();
+        if (fclose(file) != 0 || !written) {
+            printf("Failed to write %s\n", path.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    //True if count elements of elementSize bytes at offset lie inside a file of size bytes
+    static bool inFile(uint64_t offset, uint64_t count, uint64_t elementSize, size_t size)
+    {
+        if (offset > size)
+            return false;
+        return elementSize == 0 || count <= (size - offset) / elementSize;
+    }
+
+    static bool readMesh(const unsigned char* data, size_t size, const CookedMesh& cooked, size_t nodeCount, CookedMeshView& out)
+    {
+        const uint64_t indexSize = cooked.indexType == (uint32_t)ew::IndexType::UINT16 ? 2 : 4;
+        if (cooked.indexType > (uint32_t)ew::IndexType::UINT32 || cooked.node < 0 || (size_t)cooked.node >= nodeCount
+            || cooked.verticesOffset % COOKED_ALIGNMENT != 0 || cooked.indicesOffset % COOKED_ALIGNMENT != 0
+            || !inFile(cooked.verticesOffset, cooked.vertexCount, sizeof(Vertex), size)
+            || !inFile(cooked.indicesOffset, cooked.indexBytes, 1, size)
+            || !inFile(cooked.chunksOffset, cooked.chunkCount, sizeof(CookedIndexChunk), size)
+            || !inFile(cooked.lodsOffset, cooked.lodCount, sizeof(CookedLod), size)
+            || !inFile(cooked.meshletsOffset, cooked.meshletCount, sizeof(CookedMeshlet), size)
+            || cooked.lodCount == 0 || (uint64_t)cooked.indexCount * indexSize > cooked.indexBytes)
+            return false;
+
+        out.vertices = (const Vertex*)(data + cooked.verticesOffset);
+        out.vertexCount = cooked.vertexCount;
+        out.indexData = data + cooked.indicesOffset;
+        out.indexDataSize = cooked.indexBytes;
+        out.indexCount = cooked.indexCount;
+        out.node = cooked.node;
+        memcpy(&out.bounds.min, cooked.boundsMin, sizeof(cooked.boundsMin));
+        memcpy(&out.bounds.max, cooked.boundsMax, sizeof(cooked.boundsMax));
+
+        //Chunks must cover indices inside the blob, and every index plus its chunk's base vertex must be in the vertex buffer.
+        //Reads each index once, so a bad file can't make the GPU or AddToArena read out of bounds
+        out.indexLayout.type = (ew::IndexType)cooked.indexType;
+        const CookedIndexChunk* chunks = (const CookedIndexChunk*)(data + cooked.chunksOffset);
+        for (uint32_t i = 0; i < cooked.chunkCount; i++)
+        {
+            const CookedIndexChunk& c = chunks[i];
+            if ((uint64_t)c.firstIndex + c.count > cooked.indexCount || c.baseVertex < 0)
+                return false;
+            for (uint64_t j = c.firstIndex; j < (uint64_t)c.firstIndex + c.count; j++)
+            {
+                const uint64_t index = indexSize == 2 ? ((const uint16_t*)out.indexData)[j] : ((const uint32_t*)out.indexData)[j];
+                if (index + (uint64_t)c.baseVertex >= cooked.vertexCount)
+                    return false;
+            }
+            out.indexLayout.chunks.push_back({ c.firstIndex, c.count, c.baseVertex });
+        }
+        const CookedLod* lods = (const CookedLod*)(data + cooked.lodsOffset);
+        for (uint32_t i = 0; i < cooked.lodCount; i++)
+        {
+            if ((uint64_t)lods[i].firstIndex + lods[i].indexCount > cooked.indexCount)
+                return false;
+            out.lods.push_back({ lods[i].firstIndex, lods[i].indexCount, lods[i].error });
+        }
+        const CookedMeshlet* meshlets = (const CookedMeshlet*)(data + cooked.meshletsOffset);
+        for (uint32_t i = 0; i < cooked.meshletCount; i++)
+        {
+            const CookedMeshlet& c = meshlets[i];
+            if ((uint64_t)c.firstIndex + c.indexCount > cooked.indexCount)
+                return false;
+            ew::Meshlet meshlet;
+            meshlet.firstIndex = c.firstIndex;
+            meshlet.indexCount = c.indexCount;
+            meshlet.vertexCount = c.vertexCount;
+            meshlet.bounds.center = ew::Vec3(c.center[0], c.center[1], c.center[2]);
+            meshlet.bounds.radius = c.radius;
+            meshlet.coneAxis = ew::Vec3(c.coneAxis[0], c.coneAxis[1], c.coneAxis[2]);
+            meshlet.coneSin = c.coneSin;
+            meshlet.coneCos = c.coneCos;
+            out.meshlets.push_back(meshlet);
+        }
+        uint64_t offset = cooked.texturesOffset;
+        for (uint32_t i = 0; i < cooked.textureCount; i++)
+        {
+            uint32_t lengths[2];
+            if (!inFile(offset, 1, sizeof(lengths), size))
+                return false;
+            memcpy(lengths, data + offset, sizeof(lengths));
+            offset += sizeof(lengths);
+            if (!inFile(offset, (uint64_t)lengths[0] + lengths[1], 1, size))
+                return false;
+            const char* text = (const char*)(data + offset);
+            out.textures.push_back({ std::string(text, lengths[0]), std::string(text + lengths[0], lengths[1]) });
+            offset += (uint64_t)lengths[0] + lengths[1];
+        }
+        return true;
+    }
+
+    bool ReadCookedModel(const unsigned char* data, size_t size, CookedModelView& out)
+    {
+        out = CookedModelView();
+        if (!data || size < sizeof(CookedHeader)) {
+            printf("Cooked model is truncated\n");
+            return false;
+        }
+        const CookedHeader& header = *(const CookedHeader*)data;
+        if (memcmp(header.magic, COOKED_MODEL_MAGIC, sizeof(header.magic)) != 0) {
+            printf("Not a cooked model\n");
+            return false;
+        }
+        if (header.version != COOKED_MODEL_VERSION || header.vertexSize != sizeof(Vertex)) {
+            printf("Cooked model is version %u, expected %u. Recook it with ewcook\n", header.version, COOKED_MODEL_VERSION);
+            return false;
+        }
+        if (!inFile(header.nodesOffset, header.nodeCount, sizeof(CookedNode), size) || !inFile(header.meshesOffset, header.meshCount, sizeof(CookedMesh), size)) {
+            printf("Cooked model is truncated\n");
+            return false;
+        }
+        out.weldStats.verticesBefore = (size_t)header.verticesBeforeWeld;
+        out.weldStats.verticesAfter = (size_t)header.verticesAfterWeld;
+
+        const CookedNode* nodes = (const CookedNode*)(data + header.nodesOffset);
+        for (uint32_t i = 0; i < header.nodeCount; i++)
+        {
+            //Parents before children, as TransformHierarchy needs
+            if (nodes[i].parent != ew::TransformHierarchy::NO_PARENT && (nodes[i].parent < 0 || (uint32_t)nodes[i].parent >= i)) {
+                printf("Cooked model has a bad node hierarchy\n");
+                return false;
+            }
+            ew::Mat4 local;
+            memcpy(&local, nodes[i].local, sizeof(nodes[i].local));
+            out.nodeLocals.push_back(local);
+            out.nodeParents.push_back(nodes[i].parent);
+        }
+
+        const CookedMesh* meshes = (const CookedMesh*)(data + header.meshesOffset);
+        out.meshes.resize(header.meshCount);
+        for (uint32_t i = 0; i < header.meshCount; i++)
+        {
+            if (!readMesh(data, size, meshes[i], out.nodeLocals.size(), out.meshes[i])) {
+                printf("Cooked model mesh %u is corrupt\n", i);
+                out = CookedModelView();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool LoadCookedModel(const std::string& path, CookedModel& out)
+    {
+        out.file = std::make_shared<ew::MappedFile>();
+        if (!out.file->open(path.c_str()) || !ReadCookedModel(out.file->data(), out.file->size(), out.view))
+        {
+            printf("Failed to load cooked model %s\n", path.c_str());
+            out = CookedModel();
+            return false;
+        }
+        out.directory = path.substr(0, path.find_last_of('/')); //Textures sit next to the cooked file, same as the source
+        return true;
+    }
+
+    bool IsCookedModelPath(const std::string& path)
+    {
+        const size_t length = strlen(COOKED_MODEL_EXTENSION);
+        return path.size() >= length && path.compare(path.size() - length, length, COOKED_MODEL_EXTENSION) == 0;
+    }
+}
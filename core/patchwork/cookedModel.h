@@ -0,0 +1,136 @@
+#pragma once
+#include <stdint.h>
+#include "modelImport.h"
+#include "../ew/indexBuffer.h"
+#include "../ew/mappedFile.h"
+#include <memory>
+
+//.ewmodel: an ImportedModel written by the ewcook tool in the layout Model uploads, so loading is a memory map and a few
+//glBufferData calls. All offsets are in bytes from the start of the file and every blob starts on a 16 byte boundary.
+//Fields are fixed width and little endian, matching every platform this builds for.
+
+namespace patchwork
+{
+    const char COOKED_MODEL_MAGIC[4] = { 'E', 'W', 'M', 'D' };
+    //Bump whenever a struct below or Vertex changes, old files are then rejected rather than misread
+    const uint32_t COOKED_MODEL_VERSION = 1;
+    const char* const COOKED_MODEL_EXTENSION = ".ewmodel";
+
+    struct CookedHeader
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t vertexSize; //sizeof(Vertex) when cooked
+        uint32_t meshCount;
+        uint32_t nodeCount;
+        uint32_t pad;
+        uint64_t verticesBeforeWeld;
+        uint64_t verticesAfterWeld;
+        uint64_t nodesOffset; //nodeCount CookedNodes
+        uint64_t meshesOffset; //meshCount CookedMeshes
+    };
+
+    struct CookedNode
+    {
+        float local[16]; //Mat4 memory order, column major
+        int32_t parent;
+        uint32_t pad[3];
+    };
+
+    struct CookedMesh
+    {
+        uint64_t verticesOffset; //vertexCount Vertex, ready for GL_ARRAY_BUFFER
+        uint64_t indicesOffset; //indexBytes of element buffer data, as built by ew::buildIndexBuffer
+        uint64_t indexBytes;
+        uint64_t chunksOffset; //chunkCount CookedIndexChunks
+        uint64_t lodsOffset; //lodCount CookedLods
+        uint64_t meshletsOffset; //meshletCount CookedMeshlets
+        uint64_t texturesOffset; //textureCount of: uint32 type length, uint32 path length, then both strings without terminators
+        uint32_t vertexCount;
+        uint32_t indexCount;
+        uint32_t indexType; //ew::IndexType
+        uint32_t chunkCount;
+        uint32_t lodCount;
+        uint32_t meshletCount;
+        uint32_t textureCount;
+        int32_t node;
+        float boundsMin[3];
+        float boundsMax[3];
+    };
+
+    struct CookedIndexChunk
+    {
+        uint32_t firstIndex;
+        uint32_t count;
+        int32_t baseVertex;
+        uint32_t pad;
+    };
+
+    struct CookedLod
+    {
+        uint32_t firstIndex;
+        uint32_t indexCount;
+        float error;
+        uint32_t pad;
+    };
+
+    struct CookedMeshlet
+    {
+        uint32_t firstIndex;
+        uint32_t indexCount;
+        uint32_t vertexCount;
+        float center[3];
+        float radius;
+        float coneAxis[3];
+        float coneSin;
+        float coneCos;
+    };
+
+    //One mesh of a mapped file. The blobs point into the mapping, the small tables are copied out
+    struct CookedMeshView
+    {
+        const Vertex* vertices;
+        size_t vertexCount;
+        const unsigned char* indexData; //Element buffer bytes, indexLayout describes them
+        size_t indexDataSize;
+        size_t indexCount;
+        ew::IndexBufferLayout indexLayout;
+        std::vector<ew::LodLevel> lods;
+        std::vector<ew::Meshlet> meshlets;
+        std::vector<TextureRef> textures;
+        int node;
+        ew::AABB bounds;
+    };
+
+    struct CookedModelView
+    {
+        std::vector<CookedMeshView> meshes;
+        std::vector<ew::Mat4> nodeLocals;
+        std::vector<int> nodeParents;
+        ew::WeldStats weldStats;
+    };
+
+    //A .ewmodel mapped and its tables read, ready for Model to upload. The views point into file
+    struct CookedModel
+    {
+        std::shared_ptr<ew::MappedFile> file;
+        CookedModelView view;
+        std::string directory; //Textures are loaded relative to this
+    };
+
+    //Writes model as a .ewmodel file. False, with a message printed, if the file can't be written
+    bool WriteCookedModel(const std::string& path, const ImportedModel& model);
+
+    /// <summary>
+    /// Reads the tables of a .ewmodel held in memory, normally a MappedFile. Vertex and index data aren't touched, only pointed to,
+    /// so they stay valid as long as data does. Every offset and count is checked against size, and every index against the vertex count, first.
+    /// </summary>
+    /// <returns>False, with a message printed, if the data isn't a valid file of this version</returns>
+    bool ReadCookedModel(const unsigned char* data, size_t size, CookedModelView& out);
+
+    //Maps path and reads it with ReadCookedModel. Makes no GL calls. False, with a message printed, on failure
+    bool LoadCookedModel(const std::string& path, CookedModel& out);
+
+    //True if path ends in COOKED_MODEL_EXTENSION
+    bool IsCookedModelPath(const std::string& path);
+}
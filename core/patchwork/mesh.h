@@ -5,6 +5,11 @@
 #include "../ew/ewMath/ewMath.h"
 #include "../ew/external/glad.h"
 #include "../ew/shader.h"
+#include "../ew/indexBuffer.h"
+#include "../ew/lod.h"
+#include "../ew/meshlet.h"
+#include "../ew/instancing.h"
+#include "../ew/ringBuffer.h"
 #include "transformations.h"
 
 //Credit to LearnOpenGl for the guide. 
@@ -31,16 +36,40 @@ namespace patchwork
 		std::vector<Vertex> vertices;
 		std::vector<unsigned int> indices;
 		std::vector<Texture> textures;
+		std::vector<ew::LodLevel> lods; //Ranges of indices, finest first. Never empty, the constructors add a single level covering every index if none are given
+		std::vector<ew::Meshlet> meshlets; //Clusters of LOD 0, which is stored in meshlet order. Empty if not built
 
-		Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, std::vector<Texture> textures) //Mesh default constructur.
+		Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, std::vector<Texture> textures, std::vector<ew::LodLevel> lods = {}, std::vector<ew::Meshlet> meshlets = {}) //Mesh default constructur.
 		{
 			this->vertices = vertices;
 			this->indices = indices;
 			this->textures = textures;
+			this->lods = lods;
+			this->meshlets = meshlets;
+			if (this->lods.empty())
+				this->lods.push_back({ 0, indices.size(), 0.0f });
 
 			setupMesh();
 		}
-		void Draw(ew::Shader& shader)
+		//Uploads vertex and element buffer data prepared offline, e.g. mapped from a cooked model, without touching it on the CPU.
+		//vertices and indices stay empty
+		Mesh(const Vertex* vertexData, size_t vertexCount, const void* indexData, size_t indexDataSize, const ew::IndexBufferLayout& indexLayout,
+			std::vector<Texture> textures, std::vector<ew::LodLevel> lods, std::vector<ew::Meshlet> meshlets = {})
+		{
+			this->textures = textures;
+			this->lods = lods;
+			this->meshlets = meshlets;
+			this->indexLayout = indexLayout;
+			if (this->lods.empty())
+				this->lods.push_back({ 0, indexDataSize / indexLayout.indexSize(), 0.0f });
+			uploadMesh(vertexData, vertexCount, indexData, indexDataSize);
+		}
+		void Draw(ew::Shader& shader, size_t lod = 0)
+		{
+			DrawInstanced(shader, 1, lod);
+		}
+		//Draws instanceCount copies in one call, placed by the buffer given to SetInstanceBuffer
+		void DrawInstanced(ew::Shader& shader, int instanceCount, size_t lod = 0)
 		{
 			unsigned int diffuseNr = 1;
 			unsigned int specularNr = 1;
@@ -61,14 +90,40 @@ namespace patchwork
 
 			//draw the mesh
 			glBindVertexArray(VAO);
-			glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
+			const ew::LodLevel& level = lods[std::min(lod, lods.size() - 1)];
+			ew::drawIndexedRange(GL_TRIANGLES, indexLayout, level.firstIndex, level.indexCount, instanceCount);
+			glBindVertexArray(0);
+		}
+		//Per instance attributes for DrawInstanced
+		void SetInstanceBuffer(ew::InstanceBuffer& instances)
+		{
+			glBindVertexArray(VAO);
+			instances.bindAttributes();
+			glBindVertexArray(0);
+		}
+		//Same, with instances written to a RingBuffer this frame
+		void SetInstanceBuffer(const ew::RingAllocation& instances)
+		{
+			glBindVertexArray(VAO);
+			ew::setInstanceAttributes();
+			glBindVertexBuffer(ew::INSTANCE_BINDING, instances.buffer, instances.offset, sizeof(ew::InstanceData));
 			glBindVertexArray(0);
 		}
 
+		inline ew::IndexType getIndexType() const { return indexLayout.type; }
+
 	private:
 		unsigned int VAO, VBO, EBO;
+		ew::IndexBufferLayout indexLayout; //16 bit whenever the vertex count allows it
 
 		void setupMesh()
+		{
+			std::vector<unsigned char> indexData;
+			indexLayout = ew::buildIndexBuffer(indices.data(), indices.size(), vertices.size(), indexData);
+			uploadMesh(vertices.data(), vertices.size(), indexData.data(), indexData.size());
+		}
+
+		void uploadMesh(const Vertex* vertexData, size_t vertexCount, const void* indexData, size_t indexDataSize)
 		{
 			glGenVertexArrays(1, &VAO);
 			glGenBuffers(1, &VBO);
@@ -77,10 +132,10 @@ namespace patchwork
 			glBindVertexArray(VAO);
 			glBindBuffer(GL_ARRAY_BUFFER, VBO);
 
-			glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);
+			glBufferData(GL_ARRAY_BUFFER, vertexCount * sizeof(Vertex), vertexData, GL_STATIC_DRAW);
 
 			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-			glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
+			glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexDataSize, indexData, GL_STATIC_DRAW);
 
 			//vert positions
 			glEnableVertexAttribArray(0);
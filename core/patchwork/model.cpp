@@ -1,15 +1,35 @@
 #pragma once
 
 #include "model.h"
-#include "../ew/external/stb_image.h"
+#include "../ew/textureCache.h"
 
 namespace patchwork
 {
-    unsigned int TextureFromFile(const char* path, const std::string& directory, bool gamma = false); //Prolly put this in the wrong place lmao but special method for grabbing the texture from the file.
+    unsigned int TextureFromFile(const char* path, const std::string& directory, bool gamma = false); //Prolly put this in the wrong place lmao but special method for grabbing the texture from the file. Takes a reference in the global texture cache, loaded asynchronously.
 
-    Model::Model(char* path)
+    Model::Model(char* path, const ModelImportSettings& settings)
     {
-        loadModel(path);
+        const std::string file = path;
+        if (IsCookedModelPath(file))
+        {
+            CookedModel cooked;
+            if (LoadCookedModel(file, cooked))
+                create(cooked);
+            return;
+        }
+        ImportedModel imported;
+        if (ImportModel(file, settings, imported))
+            create(imported);
+    }
+
+    Model::Model(const ImportedModel& imported)
+    {
+        create(imported);
+    }
+
+    Model::Model(const CookedModel& cooked)
+    {
+        create(cooked);
     }
 
     void Model::Draw(ew::Shader& shader)
@@ -18,163 +38,224 @@ namespace patchwork
             meshes[i].Draw(shader);
     }
 
-    void Model::loadModel(std::string path)
+    void Model::Draw(ew::Shader& shader, const ew::Mat4& modelMatrix)
     {
-        Assimp::Importer import;
-        const aiScene * scene = import.ReadFile(path, aiProcess_Triangulate | aiProcess_FlipUVs); //Create the scene from the data file.
-
-        if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) //Make sure the scene loaded.
+        if (!hasNodeTransforms)
         {
-            printf("ERROR::ASSIMP::"); 
-            printf(import.GetErrorString());
+            shader.setMat4("_Model", modelMatrix);
+            shader.setMat3("_NormalMatrix", ew::NormalMatrix(modelMatrix));
+            Draw(shader);
             return;
         }
-        directory = path.substr(0, path.find_last_of('/')); //Store the file directory.
-
-        processNode(scene->mRootNode, scene); //pass over.
+        for (unsigned int i = 0; i < meshes.size(); i++)
+        {
+            const ew::Mat4 meshMatrix = modelMatrix * nodes.getWorld(meshNodes[i]);
+            shader.setMat4("_Model", meshMatrix);
+            shader.setMat3("_NormalMatrix", ew::NormalMatrix(meshMatrix));
+            meshes[i].Draw(shader);
+        }
     }
 
-    void Model::processNode(aiNode* node, const aiScene* scene)
+    void Model::Draw(ew::Shader& shader, const ew::Mat4& modelMatrix, const ew::Camera& camera, float screenHeight, float maxScreenError)
     {
-        //process all the nodes meshes (if any)
-        for (unsigned int i = 0; i < node->mNumMeshes; i++)
-        {
-            aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
-            meshes.push_back(processMesh(mesh, scene));
-        }
-        //then do the same for each of its children 
-        for (unsigned int i = 0; i < node->mNumChildren; i++)
+        for (unsigned int i = 0; i < meshes.size(); i++)
         {
-            processNode(node->mChildren[i], scene);
+            const ew::Mat4 matrix = meshMatrix(i, modelMatrix);
+            if (i == 0 || hasNodeTransforms)
+            {
+                shader.setMat4("_Model", matrix);
+                shader.setMat3("_NormalMatrix", ew::NormalMatrix(matrix));
+            }
+            meshes[i].Draw(shader, selectLod(i, matrix, camera, screenHeight, maxScreenError));
         }
     }
 
-    Mesh Model::processMesh(aiMesh* mesh, const aiScene* scene)
+    void Model::AddToArena(ew::GeometryArena& arena)
     {
-        std::vector<Vertex> vertices;
-        std::vector<unsigned int> indices;
-        std::vector<Texture> textures;
-
-        for (unsigned int i = 0; i < mesh->mNumVertices; i++) //Process each vertex.
+        static_assert(sizeof(Vertex) == sizeof(ew::Vertex) && offsetof(Vertex, Normal) == offsetof(ew::Vertex, normal) && offsetof(Vertex, TexCoords) == offsetof(ew::Vertex, uv),
+            "patchwork::Vertex must match ew::Vertex to share an arena");
+        arenaMeshes.clear();
+        for (unsigned int i = 0; i < meshes.size(); i++)
         {
-            Vertex vertex;
-            ew::Vec3 vector;
-            vector.x = mesh->mVertices[i].x;
-            vector.y = mesh->mVertices[i].y;
-            vector.z = mesh->mVertices[i].z;
-            vertex.Position = vector;
-
-            vector.x = mesh->mNormals[i].x;
-            vector.y = mesh->mNormals[i].y;
-            vector.z = mesh->mNormals[i].z;
-            vertex.Normal = vector;
-
-            if (mesh->mTextureCoords[0]) //Check if there are texture coordinates
+            const Mesh& mesh = meshes[i];
+            if (cookedMeshes.empty())
             {
-                ew::Vec2 vec;
-                vec.x = mesh->mTextureCoords[0][i].x;
-                vec.y = mesh->mTextureCoords[0][i].y;
-                vertex.TexCoords = vec;
+                arenaMeshes.push_back(arena.add((const ew::Vertex*)mesh.vertices.data(), mesh.vertices.size(), mesh.indices.data(), mesh.indices.size()));
+                continue;
             }
-            else
-                vertex.TexCoords = ew::Vec2(0.0f, 0.0f);
-
-            vertices.push_back(vertex);
+            //Cooked indices may be 16 bit chunks, the arena wants them 32 bit and absolute. ReadCookedModel already checked every one is in range
+            const CookedMeshView& cooked = cookedMeshes[i];
+            std::vector<unsigned int> indices(cooked.indexCount, 0);
+            for (const ew::IndexChunk& chunk : cooked.indexLayout.chunks)
+            {
+                for (size_t j = chunk.firstIndex; j < chunk.firstIndex + chunk.count; j++)
+                {
+                    const unsigned int index = cooked.indexLayout.type == ew::IndexType::UINT16
+                        ? ((const unsigned short*)cooked.indexData)[j] : ((const unsigned int*)cooked.indexData)[j];
+                    indices[j] = index + chunk.baseVertex;
+                }
+            }
+            arenaMeshes.push_back(arena.add((const ew::Vertex*)cooked.vertices, cooked.vertexCount, indices.data(), indices.size()));
         }
-        // process indices
-        for (unsigned int i = 0; i < mesh->mNumFaces; i++)
+    }
+
+    void Model::AddDraws(ew::DrawList& drawList, const ew::Mat4& modelMatrix, const ew::Camera& camera, float screenHeight, float maxScreenError)
+    {
+        for (unsigned int i = 0; i < arenaMeshes.size(); i++)
         {
-            aiFace face = mesh->mFaces[i];
-            for (unsigned int j = 0; j < face.mNumIndices; j++)
-                indices.push_back(face.mIndices[j]);
+            if (!meshes[i].textures.empty())
+                continue;
+            const ew::Mat4 matrix = meshMatrix(i, modelMatrix);
+            const std::vector<ew::LodLevel>& lods = meshes[i].lods;
+            const size_t lod = std::min(selectLod(i, matrix, camera, screenHeight, maxScreenError), lods.size() - 1);
+            const std::vector<ew::Meshlet>& meshlets = meshes[i].meshlets;
+            if (lod == 0 && !meshlets.empty())
+            {
+                ew::CullMeshlets(ew::MakeMeshletView(camera, matrix), meshlets.data(), meshlets.size(), drawList, arenaMeshes[i], matrix);
+                continue;
+            }
+            drawList.add(arenaMeshes[i], lods[lod].firstIndex, lods[lod].indexCount, matrix);
         }
+    }
 
-        // process material
-        if (mesh->mMaterialIndex >= 0)
+    void Model::DrawTextured(ew::Shader& shader, const ew::Mat4& modelMatrix, const ew::Camera& camera, float screenHeight, float maxScreenError)
+    {
+        for (unsigned int i = 0; i < meshes.size(); i++)
         {
-            aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
-            std::vector<Texture> diffuseMaps = loadMaterialTextures(material, aiTextureType_DIFFUSE, "texture_diffuse");
-            textures.insert(textures.end(), diffuseMaps.begin(), diffuseMaps.end());
-            std::vector<Texture> specularMaps = loadMaterialTextures(material, aiTextureType_SPECULAR, "texture_specular");
-            textures.insert(textures.end(), specularMaps.begin(), specularMaps.end());
+            if (meshes[i].textures.empty())
+                continue;
+            const ew::Mat4 matrix = meshMatrix(i, modelMatrix);
+            shader.setMat4("_Model", matrix);
+            shader.setMat3("_NormalMatrix", ew::NormalMatrix(matrix));
+            meshes[i].Draw(shader, selectLod(i, matrix, camera, screenHeight, maxScreenError));
         }
+    }
+
+    ew::Mat4 Model::meshMatrix(unsigned int mesh, const ew::Mat4& modelMatrix) const
+    {
+        return hasNodeTransforms ? modelMatrix * nodes.getWorld(meshNodes[mesh]) : modelMatrix;
+    }
 
-        return Mesh(vertices, indices, textures);
+    size_t Model::selectLod(unsigned int mesh, const ew::Mat4& meshMatrix, const ew::Camera& camera, float screenHeight, float maxScreenError) const
+    {
+        //LOD errors are relative to the mesh's bounding sphere radius
+        const ew::AABB& localBounds = meshLocalBounds[mesh];
+        const ew::BoundingSphere sphere = ew::TransformSphere({ localBounds.center(), ew::Magnitude(localBounds.extents()) }, meshMatrix);
+        return ew::SelectLod(meshes[mesh].lods, ew::ProjectedRadius(camera, sphere.center, sphere.radius, screenHeight), maxScreenError);
     }
 
-    std::vector<Texture> Model::loadMaterialTextures(aiMaterial* mat, aiTextureType type, std::string typeName)
+    void Model::SetInstanceBuffer(ew::InstanceBuffer& instances)
     {
-        std::vector<Texture> textures;
-        for (unsigned int i = 0; i < mat->GetTextureCount(type); i++)
+        for (unsigned int i = 0; i < meshes.size(); i++)
+            meshes[i].SetInstanceBuffer(instances);
+    }
+
+    void Model::SetInstanceBuffer(const ew::RingAllocation& instances)
+    {
+        for (unsigned int i = 0; i < meshes.size(); i++)
+            meshes[i].SetInstanceBuffer(instances);
+    }
+
+    void Model::DrawInstanced(ew::Shader& shader, int instanceCount, size_t lod)
+    {
+        for (unsigned int i = 0; i < meshes.size(); i++)
         {
-            aiString str;
-            mat->GetTexture(type, i, &str);
-            bool skip = false;
-            for (unsigned int j = 0; j < textures_loaded.size(); j++)
+            if (i == 0 || hasNodeTransforms)
             {
-                if (std::strcmp(textures_loaded[j].path.data(), str.C_Str()) == 0)
-                {
-                    textures.push_back(textures_loaded[j]);
-                    skip = true;
-                    break;
-                }
-            }
-            if (!skip)
-            {   //Check if the texture has been loaded
-                Texture texture;
-                texture.id = TextureFromFile(str.C_Str(), directory);
-                texture.type = typeName;
-                texture.path = str.C_Str();
-                textures.push_back(texture);
-                textures_loaded.push_back(texture); // add to loaded textures
+                const ew::Mat4& meshMatrix = nodes.getWorld(meshNodes[i]);
+                shader.setMat4("_Model", meshMatrix);
+                shader.setMat3("_NormalMatrix", ew::NormalMatrix(meshMatrix));
             }
+            meshes[i].DrawInstanced(shader, instanceCount, lod);
         }
-        return textures;
     }
 
-    unsigned int TextureFromFile(const char* path, const std::string & directory, bool gamma)
+    void Model::create(const ImportedModel& imported)
     {
-        std::string filename = std::string(path);
-        filename = directory + '/' + filename; //Create the full directory from the two strings.
-
-        unsigned int textureID;
-        glGenTextures(1, &textureID);
+        directory = imported.directory;
+        weldStats = imported.weldStats;
+        for (size_t i = 0; i < imported.nodeLocals.size(); i++)
+            nodes.add(imported.nodeLocals[i], imported.nodeParents[i]);
+        for (const ImportedMesh& mesh : imported.meshes)
+        {
+            meshes.push_back(Mesh(mesh.vertices, mesh.indices, loadTextures(mesh.textures), mesh.lods, mesh.meshlets));
+            meshNodes.push_back(mesh.node);
+            meshLocalBounds.push_back(mesh.bounds);
+            optimizeStats.push_back(mesh.optimizeStats);
+        }
+        finishLoad();
+    }
 
-        int width, height, nrComponents;
-        unsigned char* data = stbi_load(filename.c_str(), &width, &height, &nrComponents, 0);
-        if (data)
+    void Model::create(const CookedModel& cooked)
+    {
+        mappedFile = cooked.file;
+        directory = cooked.directory;
+        weldStats = cooked.view.weldStats;
+        for (size_t i = 0; i < cooked.view.nodeLocals.size(); i++)
+            nodes.add(cooked.view.nodeLocals[i], cooked.view.nodeParents[i]);
+        //Straight from the mapping to GL, nothing is parsed or converted on the way
+        for (const CookedMeshView& mesh : cooked.view.meshes)
         {
-            GLenum format;
-            if (nrComponents == 1)
-            {
-                format = GL_RED;
-            }  
-            else if (nrComponents == 3)
-            {
-                format = GL_RGB;
-            }
-            else if (nrComponents == 4)
-            {
-                format = GL_RGBA;
-            }
+            meshes.push_back(Mesh(mesh.vertices, mesh.vertexCount, mesh.indexData, mesh.indexDataSize, mesh.indexLayout, loadTextures(mesh.textures), mesh.lods, mesh.meshlets));
+            meshNodes.push_back(mesh.node);
+            meshLocalBounds.push_back(mesh.bounds);
+        }
+        cookedMeshes = cooked.view.meshes;
+        finishLoad();
+    }
 
-            glBindTexture(GL_TEXTURE_2D, textureID);
-            glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data); //Oh my god format is unitialized!!! Oh no!
-            glGenerateMipmap(GL_TEXTURE_2D);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    //Exact comparison, stops at the first element that differs
+    static bool isIdentity(const ew::Mat4& m)
+    {
+        static const ew::Mat4 identity = ew::IdentityMatrix();
+        for (int c = 0; c < 4; c++)
+            for (int r = 0; r < 4; r++)
+                if (m.get(c, r) != identity.get(c, r))
+                    return false;
+        return true;
+    }
+
+    void Model::finishLoad()
+    {
+        nodes.update();
 
-            stbi_image_free(data);
+        //Bounds and identity check need the resolved node matrices, so they happen after the whole tree is read
+        bounds = { ew::Vec3(INFINITY), ew::Vec3(-INFINITY) };
+        for (unsigned int i = 0; i < meshes.size(); i++)
+        {
+            const ew::Mat4& world = nodes.getWorld(meshNodes[i]);
+            ew::AABB meshBounds = ew::TransformAABB(meshLocalBounds[i], world);
+            bounds.min = ew::Vec3(fminf(bounds.min.x, meshBounds.min.x), fminf(bounds.min.y, meshBounds.min.y), fminf(bounds.min.z, meshBounds.min.z));
+            bounds.max = ew::Vec3(fmaxf(bounds.max.x, meshBounds.max.x), fmaxf(bounds.max.y, meshBounds.max.y), fmaxf(bounds.max.z, meshBounds.max.z));
+            if (!hasNodeTransforms && !isIdentity(world))
+                hasNodeTransforms = true;
         }
-        else
+        if (meshes.empty())
+            bounds = { ew::Vec3(0.0f), ew::Vec3(0.0f) };
+    }
+
+    std::vector<Texture> Model::loadTextures(const std::vector<TextureRef>& refs)
+    {
+        //Shared with every other model through the cache, each mesh's use is one reference
+        std::vector<Texture> textures;
+        for (const TextureRef& ref : refs)
         {
-            printf("Texture failed to load at path: "); 
-            printf(path);
-            stbi_image_free(data);
+            Texture texture;
+            texture.id = TextureFromFile(ref.path.c_str(), directory);
+            texture.type = ref.type;
+            texture.path = ref.path;
+            textures.push_back(texture);
+            textureReferences.emplace_back(texture.id);
         }
+        return textures;
+    }
 
-        return textureID;
+    unsigned int TextureFromFile(const char* path, const std::string & directory, bool gamma)
+    {
+        std::string filename = std::string(path);
+        filename = directory + '/' + filename; //Create the full directory from the two strings.
+        //Decoded on the global streamer's workers, the model draws with a placeholder until it is uploaded.
+        //Shared with other models by path, copies of one image under different names are each loaded
+        return ew::TextureCache::global().acquireAsync(filename);
     }
 }
\ No newline at end of file
@@ -1,6 +1,15 @@
 #pragma once
 #include "mesh.h"
-#include <assimp/Importer.hpp>
+#include "../ew/frustum.h"
+#include "../ew/transformHierarchy.h"
+#include "../ew/meshOptimizer.h"
+#include "../ew/vertexWeld.h"
+#include "../ew/drawList.h"
+#include "../ew/mappedFile.h"
+#include "../ew/textureCache.h"
+#include "modelImport.h"
+#include "cookedModel.h"
+#include <memory>
 
 //Credit to LearnOpenGl for the guide. 
 
@@ -10,17 +19,58 @@ namespace patchwork
 	class Model 
     {
     public:
-        std::vector<Texture> textures_loaded;
-        Model(char* path);
-        void Draw(ew::Shader& shader);
+        //Imports a model file through Assimp. Paths ending in .ewmodel are memory mapped and uploaded as cooked instead,
+        //with the settings they were cooked with
+        Model(char* path, const ModelImportSettings& settings = ModelImportSettings());
+        //Uploads a model imported with ImportModel, e.g. on another thread
+        Model(const ImportedModel& imported);
+        //Uploads a model mapped with LoadCookedModel
+        Model(const CookedModel& cooked);
+        void Draw(ew::Shader& shader); //Draws every mesh with whatever _Model the caller set, ignoring node transforms.
+        void Draw(ew::Shader& shader, const ew::Mat4& modelMatrix); //Sets _Model and _NormalMatrix to modelMatrix * each mesh's node transform.
+        //Same, but each mesh draws the coarsest LOD whose error stays under maxScreenError pixels for camera
+        void Draw(ew::Shader& shader, const ew::Mat4& modelMatrix, const ew::Camera& camera, float screenHeight, float maxScreenError = 1.0f);
+        //Per instance attributes for DrawInstanced, shared by every mesh
+        void SetInstanceBuffer(ew::InstanceBuffer& instances);
+        void SetInstanceBuffer(const ew::RingAllocation& instances);
+        //Draws instanceCount copies of every mesh, one call each. Sets _Model and _NormalMatrix to each mesh's node transform,
+        //which instanced shaders apply before the instance transform
+        void DrawInstanced(ew::Shader& shader, int instanceCount, size_t lod = 0);
+        //Copies every mesh into arena, once, so the model can be drawn through a DrawList built on it
+        void AddToArena(ew::GeometryArena& arena);
+        //Adds draws to a list on the same arena, at the LOD the camera overload of Draw would pick. A DrawList shares one set of
+        //textures, so meshes with material textures are left out, draw those with DrawTextured.
+        //LOD 0 of meshes with meshlets only draws the clusters that can be seen
+        void AddDraws(ew::DrawList& drawList, const ew::Mat4& modelMatrix, const ew::Camera& camera, float screenHeight, float maxScreenError = 1.0f);
+        //The meshes AddDraws leaves out, one call each with their textures bound, like the camera overload of Draw
+        void DrawTextured(ew::Shader& shader, const ew::Mat4& modelMatrix, const ew::Camera& camera, float screenHeight, float maxScreenError = 1.0f);
+        inline const ew::AABB& getBounds() const { return bounds; } //Model space bounds of all meshes, node transforms applied
+        inline const ew::TransformHierarchy& getNodes() const { return nodes; }
+        //Vertex cache stats of each mesh before and after import optimization, same order as meshes. Empty for cooked models
+        inline const std::vector<ew::MeshOptimizeStats>& getOptimizeStats() const { return optimizeStats; }
+        //Vertex counts of all meshes before and after welding
+        inline const ew::WeldStats& getWeldStats() const { return weldStats; }
     private:
         std::vector<Mesh> meshes;
+        std::vector<int> meshNodes; //Node each mesh belongs to, same order as meshes
+        std::vector<ew::AABB> meshLocalBounds; //Bounds of each mesh before its node transform
+        std::vector<ew::MeshOptimizeStats> optimizeStats;
+        std::vector<int> arenaMeshes; //Handle of each mesh in the arena given to AddToArena
+        ew::WeldStats weldStats;
+        ew::TransformHierarchy nodes; //Imported aiNode transforms
+        bool hasNodeTransforms = false; //False when every mesh sits at identity, so Draw can skip the per mesh multiply
         std::string directory;
+        ew::AABB bounds = { ew::Vec3(0.0f), ew::Vec3(0.0f) };
+        std::shared_ptr<ew::MappedFile> mappedFile; //Cooked models keep their file mapped, the meshes have no CPU copy of their geometry
+        std::vector<CookedMeshView> cookedMeshes; //Points into mappedFile, same order as meshes
+        std::vector<ew::TextureReference> textureReferences; //Released when the model goes, so models move but don't copy
 
-        void loadModel(std::string path);
-        void processNode(aiNode* node, const aiScene* scene);
-        Mesh processMesh(aiMesh* mesh, const aiScene* scene);
-        std::vector<Texture> loadMaterialTextures(aiMaterial* mat, aiTextureType type, std::string typeName);
+        void create(const ImportedModel& imported);
+        void create(const CookedModel& cooked);
+        void finishLoad();
+        ew::Mat4 meshMatrix(unsigned int mesh, const ew::Mat4& modelMatrix) const;
+        size_t selectLod(unsigned int mesh, const ew::Mat4& meshMatrix, const ew::Camera& camera, float screenHeight, float maxScreenError) const;
+        std::vector<Texture> loadTextures(const std::vector<TextureRef>& refs);
     };
 
 }
\ No newline at end of file
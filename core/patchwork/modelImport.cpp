@@ -0,0 +1,162 @@
+#include "modelImport.h"
+#include <assimp/Importer.hpp>
+#include <math.h>
+#include <memory>
+
+namespace patchwork
+{
+    static const size_t MIN_LOD_INDICES = 3 * 512; //Meshes with fewer triangles only get level 0
+    static const size_t MIN_MESHLET_INDICES = 3 * 4 * ew::MESHLET_MAX_TRIANGLES; //A handful of clusters isn't worth culling one by one
+
+    static void importMaterialTextures(aiMaterial* mat, aiTextureType type, const std::string& typeName, std::vector<TextureRef>& textures)
+    {
+        for (unsigned int i = 0; i < mat->GetTextureCount(type); i++)
+        {
+            aiString str;
+            mat->GetTexture(type, i, &str);
+            textures.push_back({ typeName, str.C_Str() });
+        }
+    }
+
+    static void importMesh(aiMesh* mesh, const aiScene* scene, const ModelImportSettings& settings, ImportedModel& model, ImportedMesh& out)
+    {
+        out.bounds = { ew::Vec3(INFINITY), ew::Vec3(-INFINITY) };
+        std::vector<Vertex>& vertices = out.vertices;
+        std::vector<unsigned int>& indices = out.indices;
+        vertices.reserve(mesh->mNumVertices);
+
+        for (unsigned int i = 0; i < mesh->mNumVertices; i++) //Process each vertex.
+        {
+            Vertex vertex;
+            ew::Vec3 vector;
+            vector.x = mesh->mVertices[i].x;
+            vector.y = mesh->mVertices[i].y;
+            vector.z = mesh->mVertices[i].z;
+            vertex.Position = vector;
+            out.bounds.min = ew::Vec3(fminf(out.bounds.min.x, vector.x), fminf(out.bounds.min.y, vector.y), fminf(out.bounds.min.z, vector.z));
+            out.bounds.max = ew::Vec3(fmaxf(out.bounds.max.x, vector.x), fmaxf(out.bounds.max.y, vector.y), fmaxf(out.bounds.max.z, vector.z));
+
+            vector.x = mesh->mNormals[i].x;
+            vector.y = mesh->mNormals[i].y;
+            vector.z = mesh->mNormals[i].z;
+            vertex.Normal = vector;
+
+            if (mesh->mTextureCoords[0]) //Check if there are texture coordinates
+            {
+                ew::Vec2 vec;
+                vec.x = mesh->mTextureCoords[0][i].x;
+                vec.y = mesh->mTextureCoords[0][i].y;
+                vertex.TexCoords = vec;
+            }
+            else
+                vertex.TexCoords = ew::Vec2(0.0f, 0.0f);
+
+            vertices.push_back(vertex);
+        }
+        // process indices. Everything below works on triangle lists, so stray points and lines are dropped
+        indices.reserve(mesh->mNumFaces * 3);
+        for (unsigned int i = 0; i < mesh->mNumFaces; i++)
+        {
+            const aiFace& face = mesh->mFaces[i];
+            if (face.mNumIndices != 3)
+                continue;
+            indices.insert(indices.end(), face.mIndices, face.mIndices + 3);
+        }
+
+        // process material
+        if (mesh->mMaterialIndex >= 0)
+        {
+            aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
+            importMaterialTextures(material, aiTextureType_DIFFUSE, "texture_diffuse", out.textures);
+            importMaterialTextures(material, aiTextureType_SPECULAR, "texture_specular", out.textures);
+        }
+
+        //Exporters often split vertices per face, which defeats the vertex cache and makes every edge a seam for LOD
+        if (settings.weld)
+        {
+            const ew::WeldLayout layout = { sizeof(Vertex), offsetof(Vertex, Position), offsetof(Vertex, Normal), offsetof(Vertex, TexCoords) };
+            const ew::WeldStats welded = ew::WeldVertices(vertices.data(), vertices.size(), layout, indices.data(), indices.size(), settings.weldTolerances);
+            vertices.resize(welded.verticesAfter);
+            model.weldStats.verticesBefore += welded.verticesBefore;
+            model.weldStats.verticesAfter += welded.verticesAfter;
+        }
+
+        //Files come in whatever triangle order the exporter used, reorder for the vertex cache, overdraw and fetch
+        size_t vertexCount = vertices.size();
+        out.optimizeStats = ew::OptimizeMesh(vertices.data(), sizeof(Vertex), offsetof(Vertex, Position), vertexCount, indices.data(), indices.size());
+        vertices.resize(vertexCount);
+
+        //Level 0 is kept in meshlet order, the chain below copies it first
+        if (settings.buildMeshlets && indices.size() >= MIN_MESHLET_INDICES)
+        {
+            std::vector<unsigned int> meshletIndices;
+            out.meshlets = ew::BuildMeshlets(indices.data(), indices.size(), &vertices[0].Position.x, sizeof(Vertex), vertices.size(), meshletIndices);
+            indices.swap(meshletIndices);
+        }
+
+        //LOD chain sharing the vertices. Small meshes aren't worth it
+        if (indices.size() >= MIN_LOD_INDICES)
+        {
+            std::vector<unsigned int> lodIndices;
+            out.lods = ew::BuildLodChain(indices.data(), indices.size(), &vertices[0].Position.x, sizeof(Vertex), vertices.size(), lodIndices);
+            indices.swap(lodIndices);
+        }
+        else
+            out.lods.push_back({ 0, indices.size(), 0.0f });
+    }
+
+    static void importNode(aiNode* node, const aiScene* scene, int parent, const ModelImportSettings& settings, ImportedModel& model)
+    {
+        //assimp matrices are row major, Mat4 takes its arguments in row order
+        const aiMatrix4x4& m = node->mTransformation;
+        const int nodeIndex = (int)model.nodeLocals.size();
+        model.nodeLocals.push_back(ew::Mat4(
+            m.a1, m.a2, m.a3, m.a4,
+            m.b1, m.b2, m.b3, m.b4,
+            m.c1, m.c2, m.c3, m.c4,
+            m.d1, m.d2, m.d3, m.d4
+        ));
+        model.nodeParents.push_back(parent);
+
+        //process all the nodes meshes (if any)
+        for (unsigned int i = 0; i < node->mNumMeshes; i++)
+        {
+            //SortByPType leaves point and line primitives in meshes of their own
+            if (!(scene->mMeshes[node->mMeshes[i]]->mPrimitiveTypes & aiPrimitiveType_TRIANGLE))
+                continue;
+            model.meshes.emplace_back();
+            ImportedMesh& mesh = model.meshes.back();
+            mesh.node = nodeIndex;
+            importMesh(scene->mMeshes[node->mMeshes[i]], scene, settings, model, mesh);
+        }
+        //then do the same for each of its children. Visiting the node first keeps parents before children
+        for (unsigned int i = 0; i < node->mNumChildren; i++)
+        {
+            importNode(node->mChildren[i], scene, nodeIndex, settings, model);
+        }
+    }
+
+    bool ImportModel(const std::string& path, const ModelImportSettings& settings, ImportedModel& out, Assimp::Importer* importer)
+    {
+        //Importers are heavy to construct, only make one when the caller didn't pass theirs in
+        std::unique_ptr<Assimp::Importer> localImporter;
+        if (!importer) {
+            localImporter.reset(new Assimp::Importer());
+            importer = localImporter.get();
+        }
+        Assimp::Importer& import = *importer;
+        const aiScene* scene = import.ReadFile(path, aiProcess_Triangulate | aiProcess_SortByPType | aiProcess_FlipUVs); //Create the scene from the data file.
+
+        if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) //Make sure the scene loaded.
+        {
+            printf("ERROR::ASSIMP::%s\n", import.GetErrorString());
+            return false;
+        }
+        out = ImportedModel();
+        out.directory = path.substr(0, path.find_last_of('/')); //Store the file directory.
+        importNode(scene->mRootNode, scene, ew::TransformHierarchy::NO_PARENT, settings, out);
+        //The scene is owned by the importer, free it now rather than whenever a reused importer next reads
+        import.FreeScene();
+        return true;
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "mesh.h"
+#include "../ew/frustum.h"
+#include "../ew/meshOptimizer.h"
+#include "../ew/vertexWeld.h"
+#include "../ew/meshlet.h"
+#include "../ew/transformHierarchy.h"
+
+namespace Assimp {
+    class Importer;
+}
+
+//CPU side of model loading: everything up to, but not including, GL uploads. Safe to run off the GL thread and without a context.
+
+namespace patchwork
+{
+    //Import time processing applied to every mesh
+    struct ModelImportSettings
+    {
+        bool weld = true; //Merge duplicate vertices exporters write per face before optimizing
+        ew::WeldTolerances weldTolerances;
+        bool buildMeshlets = true; //Lets AddDraws cull back facing and off screen clusters of LOD 0
+    };
+
+    //A material texture, not loaded yet. path is relative to the model's directory, as written in the file
+    struct TextureRef
+    {
+        std::string type;
+        std::string path;
+    };
+
+    struct ImportedMesh
+    {
+        std::vector<Vertex> vertices;
+        std::vector<unsigned int> indices; //Every LOD back to back, LOD 0 in meshlet order when meshlets were built
+        std::vector<ew::LodLevel> lods;
+        std::vector<ew::Meshlet> meshlets;
+        std::vector<TextureRef> textures;
+        int node; //Index into ImportedModel::nodeLocals
+        ew::AABB bounds; //Before the node transform
+        ew::MeshOptimizeStats optimizeStats;
+    };
+
+    struct ImportedModel
+    {
+        std::vector<ImportedMesh> meshes;
+        std::vector<ew::Mat4> nodeLocals; //Parents always come before their children
+        std::vector<int> nodeParents; //ew::TransformHierarchy::NO_PARENT for roots
+        ew::WeldStats weldStats;
+        std::string directory; //Textures are loaded relative to this
+    };
+
+    /// <summary>
+    /// Reads a model file through Assimp, then welds, optimizes and builds meshlets and LODs for every mesh.
+    /// Makes no GL calls. Pass an importer to reuse it, otherwise a temporary one is created.
+    /// </summary>
+    /// <returns>False, after printing Assimp's error, if the file couldn't be read</returns>
+    bool ImportModel(const std::string& path, const ModelImportSettings& settings, ImportedModel& out, Assimp::Importer* importer = nullptr);
+}
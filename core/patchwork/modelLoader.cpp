@@ -0,0 +1,49 @@
+#include "modelLoader.h"
+
+namespace patchwork
+{
+    ModelLoader::ModelLoader(ew::ThreadPool& pool)
+        :pool(pool)
+    {
+    }
+
+    size_t ModelLoader::add(const std::string& path, const ModelImportSettings& settings)
+    {
+        requests.push_back({ path, settings });
+        return requests.size() - 1;
+    }
+
+    std::vector<Model> ModelLoader::loadAll()
+    {
+        //Only one of the two is filled, depending on the path
+        std::vector<ImportedModel> imported(requests.size());
+        std::vector<CookedModel> cooked(requests.size());
+        std::vector<char> isCooked(requests.size()); //Not vector<bool>, workers write neighbouring entries
+
+        //Each model is imported whole by one thread with its own importer, nothing is shared between them
+        pool.parallelFor(requests.size(), 1, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++)
+            {
+                isCooked[i] = IsCookedModelPath(requests[i].path);
+                if (!isCooked[i])
+                    ImportModel(requests[i].path, requests[i].settings, imported[i]);
+                else if (LoadCookedModel(requests[i].path, cooked[i]))
+                    cooked[i].file->prefetch(); //So the upload below copies from memory instead of waiting on the disk
+            }
+        });
+
+        std::vector<Model> models;
+        models.reserve(requests.size());
+        for (size_t i = 0; i < requests.size(); i++)
+        {
+            if (isCooked[i])
+                models.push_back(Model(cooked[i]));
+            else
+                models.push_back(Model(imported[i]));
+            //Free each model's CPU copy as soon as it is on the GPU
+            imported[i] = ImportedModel();
+        }
+        requests.clear();
+        return models;
+    }
+}
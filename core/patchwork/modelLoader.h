@@ -0,0 +1,31 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "model.h"
+#include "../ew/threadPool.h"
+
+namespace patchwork
+{
+    /// <summary>
+    /// Loads many models at once. Imports, or maps and prefetches cooked files, run in parallel on a thread pool,
+    /// each with its own Assimp::Importer, so load time scales with cores rather than model count.
+    /// Only the GL uploads run on the calling thread, which must own the context.
+    /// </summary>
+    class ModelLoader
+    {
+    public:
+        ModelLoader(ew::ThreadPool& pool = ew::ThreadPool::global());
+        //Queues a model, same paths as the Model constructor takes. Returns its index in loadAll's result
+        size_t add(const std::string& path, const ModelImportSettings& settings = ModelImportSettings());
+        //Loads everything queued and clears the queue. Models that fail to load are empty, after printing why
+        std::vector<Model> loadAll();
+    private:
+        struct Request
+        {
+            std::string path;
+            ModelImportSettings settings;
+        };
+        ew::ThreadPool& pool;
+        std::vector<Request> requests;
+    };
+}
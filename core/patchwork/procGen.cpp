@@ -1,34 +1,69 @@
 #include "procGen.h"
+#include <vector>
+#include <algorithm>
+#include "../ew/ewMath/trig.h"
+#include "../ew/threadPool.h"
+#include "../ew/procGen.h"
 
 namespace patchwork
 {
-	ew::MeshData createSphere(float radius, int numSegments)
+	//Rows per parallelFor chunk, about 16k vertices each so small meshes don't leave the calling thread
+	static size_t rowsPerChunk(int verticesPerRow)
+	{
+		return std::max(1, 16384 / std::max(verticesPerRow, 1));
+	}
+
+	ew::MeshData createSphere(float radius, int numSegments, ew::ThreadPool* pool)
 	{
 		ew::MeshData sphere;
-		ew::Vertex v;
+		const ew::MeshCounts counts = ew::querySphereCounts(numSegments);
+		sphere.vertices.resize(counts.numVertices);
+		sphere.indices.resize(counts.numIndices);
+		patchwork::createSphere(radius, numSegments, sphere.vertices.data(), sphere.indices.data(), pool);
+		return sphere;
+	}
+	void createSphere(float radius, int numSegments, ew::Vertex* verts, unsigned int* inds, ew::ThreadPool* pool)
+	{
+		ew::ThreadPool& threads = pool ? *pool : ew::ThreadPool::global();
+		const int columns = numSegments + 1;
+		const int sideRows = std::max(numSegments - 2, 0);
+
 		//Verts
 		float thetaStep = (2*ew::PI) / numSegments;
 		float phiStep = ew::PI / numSegments;
 
-		for (int row = 0; row <= numSegments; row++)
+		//Trig tables, one entry per column (theta) and per row (phi)
+		std::vector<float> angles(numSegments + 1);
+		std::vector<float> sinTheta(numSegments + 1), cosTheta(numSegments + 1);
+		std::vector<float> sinPhi(numSegments + 1), cosPhi(numSegments + 1);
+		for (int i = 0; i <= numSegments; i++)
+			angles[i] = thetaStep * i;
+		ew::SinCosN(angles.data(), sinTheta.data(), cosTheta.data(), angles.size());
+		for (int i = 0; i <= numSegments; i++)
+			angles[i] = i * phiStep;
+		ew::SinCosN(angles.data(), sinPhi.data(), cosPhi.data(), angles.size());
+
+		//Each row owns its own slice of verts
+		threads.parallelFor(columns, rowsPerChunk(columns), [&](size_t rowBegin, size_t rowEnd)
 		{
-			float phi = row * phiStep;
-			for (int col = 0; col <= numSegments; col++)
+			for (int row = (int)rowBegin; row < (int)rowEnd; row++)
 			{
-				float theta = thetaStep * col;
-				
-				v.normal.x = cosf(theta) * sinf(phi);
-				v.normal.y = cosf(phi);
-				v.normal.z = sinf(theta) * sinf(phi);
-
-				v.pos = v.normal * radius;
+				ew::Vertex* v = verts + row * columns;
+				for (int col = 0; col <= numSegments; col++, v++)
+				{
+					ew::Vertex vert; //Built here, verts may be write only mapped memory
+					vert.normal.x = cosTheta[col] * sinPhi[row];
+					vert.normal.y = cosPhi[row];
+					vert.normal.z = sinTheta[col] * sinPhi[row];
 
-				v.uv.x = float(col) / numSegments;
-				v.uv.y = 1.0 - (float(row) / numSegments);
+					vert.pos = vert.normal * radius;
 
-				sphere.vertices.push_back(v);
+					vert.uv.x = float(col) / numSegments;
+					vert.uv.y = 1.0 - (float(row) / numSegments);
+					*v = vert;
+				}
 			}
-		}
+		});
 
 		//Inds
 		unsigned int poleStart = 0;
@@ -36,174 +71,203 @@ namespace patchwork
 
 		for (int i = 0; i < numSegments; i++)
 		{
-			sphere.indices.push_back(sideStart + i);
-			sphere.indices.push_back(poleStart + i); //Pole
-			sphere.indices.push_back(sideStart + i + 1);
+			*inds++ = sideStart + i;
+			*inds++ = poleStart + i; //Pole
+			*inds++ = sideStart + i + 1;
 		}
 
-		unsigned int columns = numSegments + 1;
-
-		for (int row = 1; row < numSegments - 1; row++)
+		unsigned int* sideInds = inds;
+		threads.parallelFor(sideRows, rowsPerChunk(columns), [&](size_t rowBegin, size_t rowEnd)
 		{
-			for (int col = 0; col < numSegments; col++)
+			for (int row = (int)rowBegin + 1; row < (int)rowEnd + 1; row++)
 			{
-				int start = row * columns + col;
-				//Triangle 1
-				sphere.indices.push_back(start);
-				sphere.indices.push_back(start + 1);
-				sphere.indices.push_back(start + columns);
-				//Triangle 2
-				sphere.indices.push_back(start + columns);
-				sphere.indices.push_back(start + 1);
-				sphere.indices.push_back(start + columns + 1);
+				unsigned int* i = sideInds + (size_t)(row - 1) * numSegments * 6;
+				for (int col = 0; col < numSegments; col++)
+				{
+					int start = row * columns + col;
+					//Triangle 1
+					*i++ = start;
+					*i++ = start + 1;
+					*i++ = start + columns;
+					//Triangle 2
+					*i++ = start + columns;
+					*i++ = start + 1;
+					*i++ = start + columns + 1;
+				}
 			}
-		}
+		});
+		inds += (size_t)sideRows * numSegments * 6;
+
 		poleStart = (columns * columns) - columns;
 		sideStart = poleStart - columns;
 		for (int i = 0; i < numSegments; i++)
 		{
-			sphere.indices.push_back(sideStart + i);
-			sphere.indices.push_back(sideStart + i + 1);
-			sphere.indices.push_back(poleStart + i);
+			*inds++ = sideStart + i;
+			*inds++ = sideStart + i + 1;
+			*inds++ = poleStart + i;
 		}
-		return sphere;
 	}
-	ew::MeshData createCylinder(float height, float radius, int numSegments)
+	ew::MeshData createCylinder(float height, float radius, int numSegments, ew::ThreadPool* pool)
 	{
 		ew::MeshData cylinder;
-		ew::Vertex topVert;
-		ew::Vertex botVert;
-		ew::Vertex v;
+		const ew::MeshCounts counts = ew::queryCylinderCounts(numSegments);
+		cylinder.vertices.resize(counts.numVertices);
+		cylinder.indices.resize(counts.numIndices);
+		patchwork::createCylinder(height, radius, numSegments, cylinder.vertices.data(), cylinder.indices.data(), pool);
+		return cylinder;
+	}
+	void createCylinder(float height, float radius, int numSegments, ew::Vertex* verts, unsigned int* inds, ew::ThreadPool* pool)
+	{
+		ew::ThreadPool& threads = pool ? *pool : ew::ThreadPool::global();
+		const int columns = numSegments + 1;
+		const int numVerts = 4 * columns + 2; //Top vert, 4 rings, bottom vert
 
 		//Verts
 		float topY = height / 2; //y=0 is centered
 		float botY = -topY;
 
+		ew::Vertex topVert;
 		topVert.pos = ew::Vec3(0, topY, 0);
 		topVert.normal = ew::Vec3(0, 1, 0);
 		topVert.uv = ew::Vec2(0.5);
-		cylinder.vertices.push_back(topVert);
+		verts[0] = topVert;
 
 		float thetaStep = (2 * ew::PI) / numSegments;
-		for (int k = 1; k <= 2; k++)
+		//Every ring uses the same angles
+		std::vector<float> thetas(numSegments + 1), sinTheta(numSegments + 1), cosTheta(numSegments + 1);
+		for (int i = 0; i <= numSegments; i++)
+			thetas[i] = i * thetaStep;
+		ew::SinCosN(thetas.data(), sinTheta.data(), cosTheta.data(), thetas.size());
+
+		//Rings in order: top side, top cap, bottom side, bottom cap. Independent of each other
+		threads.parallelFor(4, columns >= 16384 ? 1 : 4, [&](size_t ringBegin, size_t ringEnd)
 		{
-			for (int j = 0; j < 2; j++)
+			for (int ring = (int)ringBegin; ring < (int)ringEnd; ring++)
 			{
-				for (int i = 0; i <= numSegments; i++)
+				const int k = ring / 2 + 1;
+				const int j = ring % 2;
+				ew::Vertex* v = verts + 1 + ring * columns;
+				for (int i = 0; i <= numSegments; i++, v++)
 				{
-					float theta = i * thetaStep;
+					const float cosA = cosTheta[i];
+					const float sinA = sinTheta[i];
 
-					v.pos.x = cos(theta) * radius;
-					v.pos.z = sin(theta) * radius;
+					v->pos.x = cosA * radius;
+					v->pos.z = sinA * radius;
 					if (k % 2 != 0)
 					{
-						v.pos.y = topY;
+						v->pos.y = topY;
 						if (j == 0)
 						{
-							v.normal = ew::Vec3(cosf(theta), 0, sinf(theta));
-							v.uv = ew::Vec2((float)i / numSegments, topY > 0 ? 1 : 0);
+							v->normal = ew::Vec3(cosA, 0, sinA);
+							v->uv = ew::Vec2((float)i / numSegments, topY > 0 ? 1 : 0);
 						}
 						else
 						{
-							v.normal = ew::Vec3(0, topY, 0);
-							v.uv = ew::Vec2(cosf(theta) * 0.5 + 0.5, sinf(theta) * 0.5 + 0.5);
+							v->normal = ew::Vec3(0, topY, 0);
+							v->uv = ew::Vec2(cosA * 0.5 + 0.5, sinA * 0.5 + 0.5);
 						}
 					}
 					else
 					{
-						v.pos.y = botY;
+						v->pos.y = botY;
 						if (j == 0)
 						{
-							v.normal = ew::Vec3(cosf(theta), 0, sinf(theta));
-							v.uv = ew::Vec2((float)i / numSegments, botY > 0 ? 1 : 0);
+							v->normal = ew::Vec3(cosA, 0, sinA);
+							v->uv = ew::Vec2((float)i / numSegments, botY > 0 ? 1 : 0);
 						}
 						else
 						{
-							v.normal = ew::Vec3(0, botY, 0);
-							v.uv = ew::Vec2(cosf(theta) * 0.5 + 0.5, sinf(theta) * 0.5 + 0.5);
+							v->normal = ew::Vec3(0, botY, 0);
+							v->uv = ew::Vec2(cosA * 0.5 + 0.5, sinA * 0.5 + 0.5);
 						}
 					}
-
-					cylinder.vertices.push_back(v);
 				}
 			}
-		}
+		});
 
+		ew::Vertex botVert;
 		botVert.pos = ew::Vec3(0, botY, 0);
 		botVert.normal = ew::Vec3(0, -1, 0);
 		botVert.uv = ew::Vec2(0.5);
-		cylinder.vertices.push_back(botVert);
+		verts[numVerts - 1] = botVert;
 
 		//Inds
-		int columns = numSegments + 1;
 		for (int i = 0; i < columns; i++)
 		{
-			cylinder.indices.push_back(0);
-			cylinder.indices.push_back(i + 1);
-			cylinder.indices.push_back(i);
+			*inds++ = 0;
+			*inds++ = i + 1;
+			*inds++ = i;
 		}
 		int sideStart = columns;
 		for (int i = 0; i < columns; i++)
 		{
 			int start = sideStart + i;
-			cylinder.indices.push_back(start);
-			cylinder.indices.push_back(start + 1);
-			cylinder.indices.push_back(start + columns);
-			cylinder.indices.push_back(start + columns);
-			cylinder.indices.push_back(start + 1);
-			cylinder.indices.push_back(start + columns + 1);
+			*inds++ = start;
+			*inds++ = start + 1;
+			*inds++ = start + columns;
+			*inds++ = start + columns;
+			*inds++ = start + 1;
+			*inds++ = start + columns + 1;
 		}
-		int bottomIndex = cylinder.vertices.size() - 1;
+		int bottomIndex = numVerts - 1;
 		sideStart = bottomIndex - columns;
 		for (int i = 0; i < columns; i++)
 		{
-			cylinder.indices.push_back(bottomIndex);
-			cylinder.indices.push_back(sideStart + i);
-			cylinder.indices.push_back(sideStart + i + 1);
+			*inds++ = bottomIndex;
+			*inds++ = sideStart + i;
+			*inds++ = sideStart + i + 1;
 		}
-
-		return cylinder;
 	}
-	ew::MeshData createPlane(float width, float height, int subdivisions)
+	ew::MeshData createPlane(float width, float height, int subdivisions, ew::ThreadPool* pool)
 	{
 		ew::MeshData plane;
-		ew::Vertex v;
+		const ew::MeshCounts counts = ew::queryPlaneCounts(subdivisions);
+		plane.vertices.resize(counts.numVertices);
+		plane.indices.resize(counts.numIndices);
+		patchwork::createPlane(width, height, subdivisions, plane.vertices.data(), plane.indices.data(), pool);
+		return plane;
+	}
+	void createPlane(float width, float height, int subdivisions, ew::Vertex* verts, unsigned int* inds, ew::ThreadPool* pool)
+	{
+		ew::ThreadPool& threads = pool ? *pool : ew::ThreadPool::global();
+		int columns = subdivisions + 1;
 
-		for (int row = 0; row <= subdivisions; row++)
+		threads.parallelFor(columns, rowsPerChunk(columns), [&](size_t rowBegin, size_t rowEnd)
 		{
-			for (int col = 0; col <= subdivisions; col++)
+			for (int row = (int)rowBegin; row < (int)rowEnd; row++)
 			{
-				v.uv.x = (float(col) / subdivisions);
-				v.uv.y = (float(row) / subdivisions);
-
-				v.pos.x = width * (col / subdivisions);
-				v.pos.y = 0;
-				v.pos.z = -height * (row / subdivisions);
-				
-				v.normal = ew::Vec3(0, 1, 0);
-				plane.vertices.push_back(v);
-			}
-		}
+				ew::Vertex* v = verts + row * columns;
+				for (int col = 0; col <= subdivisions; col++, v++)
+				{
+					v->uv.x = (float(col) / subdivisions);
+					v->uv.y = (float(row) / subdivisions);
 
-		int columns = subdivisions + 1;
+					v->pos.x = width * (col / subdivisions);
+					v->pos.y = 0;
+					v->pos.z = -height * (row / subdivisions);
 
-		for (int row = 0; row < subdivisions; row++)
-		{
-			for (int col = 0; col < subdivisions; col++)
-			{
-				int start = row * columns + col;
-				//Bottom right triangle
-				plane.indices.push_back(start);
-				plane.indices.push_back(start + 1);
-				plane.indices.push_back(start + columns + 1);
-				//Top left triangle
-				plane.indices.push_back(start);
-				plane.indices.push_back(start + columns);
-				plane.indices.push_back(start + columns + 1);
+					v->normal = ew::Vec3(0, 1, 0);
+				}
+
+				if (row == subdivisions)
+					continue;
+				unsigned int* i = inds + (size_t)row * subdivisions * 6;
+				for (int col = 0; col < subdivisions; col++)
+				{
+					int start = row * columns + col;
+					//Bottom right triangle
+					*i++ = start;
+					*i++ = start + 1;
+					*i++ = start + columns + 1;
+					//Top left triangle
+					*i++ = start;
+					*i++ = start + columns;
+					*i++ = start + columns + 1;
+				}
 			}
-		}
-		return plane;
+		});
 
 		//Used https://www.youtube.com/watch?v=FKLbihqDLsg to help with initial uv stuffs.
 	};
-}
\ No newline at end of file
+}
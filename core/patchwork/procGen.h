@@ -1,8 +1,17 @@
 //procGen.h
 #pragma once
 #include "../ew/mesh.h"
+namespace ew {
+	class ThreadPool;
+}
 namespace patchwork {
-	ew::MeshData createSphere(float radius, int numSegments);
-	ew::MeshData createCylinder(float height, float radius, int numSegments);
-	ew::MeshData createPlane(float width, float height, int subdivisions);
+	//Buffers are sized up front and rows are filled in parallel on pool (ew::ThreadPool::global() if null)
+	ew::MeshData createSphere(float radius, int numSegments, ew::ThreadPool* pool = nullptr);
+	ew::MeshData createCylinder(float height, float radius, int numSegments, ew::ThreadPool* pool = nullptr);
+	ew::MeshData createPlane(float width, float height, int subdivisions, ew::ThreadPool* pool = nullptr);
+
+	//In place versions. Same topology as the ew generators, so size verts/inds with ew::querySphereCounts/queryCylinderCounts/queryPlaneCounts
+	void createSphere(float radius, int numSegments, ew::Vertex* verts, unsigned int* inds, ew::ThreadPool* pool = nullptr);
+	void createCylinder(float height, float radius, int numSegments, ew::Vertex* verts, unsigned int* inds, ew::ThreadPool* pool = nullptr);
+	void createPlane(float width, float height, int subdivisions, ew::Vertex* verts, unsigned int* inds, ew::ThreadPool* pool = nullptr);
 }
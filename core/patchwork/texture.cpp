@@ -1,10 +1,12 @@
 #include "texture.h"
 #include "../ew/external/stb_image.h"
 #include "../ew/external/glad.h"
+#include "../ew/textureStreamer.h"
 
 unsigned int loadTexture(const char* filePath, int wrapMode, int filterMode){
 
-	stbi_set_flip_vertically_on_load(true);
+	//Per thread, decodes on texture streaming workers flip independently
+	stbi_set_flip_vertically_on_load_thread(true);
 
 	int width, height, numComponents;
 	unsigned char* data = stbi_load(filePath, &width, &height, &numComponents, 0);
@@ -53,3 +55,10 @@ unsigned int loadTexture(const char* filePath, int wrapMode, int filterMode){
 	return texture;
 }
 
+unsigned int loadTextureAsync(const char* filePath, int wrapMode, int filterMode){
+	ew::TextureSettings settings;
+	settings.wrapMode = wrapMode;
+	settings.minFilter = filterMode;
+	settings.magFilter = filterMode;
+	return ew::TextureStreamer::global().load(filePath, settings, true);
+}
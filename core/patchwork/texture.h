@@ -1,3 +1,4 @@
 #pragma once
 unsigned int loadTexture(const char* filePath, int wrapMode, int filterMode);
-
+//Same, but returns straight away with a placeholder that ew::TextureStreamer::global().update() later swaps for the image
+unsigned int loadTextureAsync(const char* filePath, int wrapMode, int filterMode);
@@ -0,0 +1,39 @@
+//Compile time checks of the constexpr math. Nothing here runs, the build fails if any of these stop folding or come out wrong.
+#include <ew/ewMath/transformations.h>
+
+namespace ew {
+	namespace {
+		constexpr bool Near(float a, float b, float epsilon = 1e-5f) {
+			return (a > b ? a - b : b - a) <= epsilon;
+		}
+
+		constexpr Mat4 identity = IdentityMatrix();
+		static_assert(identity.get(0, 0) == 1.0f && identity.get(1, 1) == 1.0f && identity.get(2, 2) == 1.0f && identity.get(3, 3) == 1.0f, "IdentityMatrix diagonal");
+		static_assert(identity.get(1, 0) == 0.0f && identity.get(3, 0) == 0.0f && identity.get(0, 3) == 0.0f && identity.get(2, 1) == 0.0f, "IdentityMatrix off diagonal");
+
+		//Translation lives in column 3
+		constexpr Mat4 translate = Translate(Vec3(1.0f, 2.0f, 3.0f));
+		static_assert(translate.get(3, 0) == 1.0f && translate.get(3, 1) == 2.0f && translate.get(3, 2) == 3.0f && translate.get(3, 3) == 1.0f, "Translate column");
+		static_assert(translate.get(0, 0) == 1.0f && translate.get(0, 3) == 0.0f, "Translate keeps the basis");
+
+		constexpr Mat4 scale = Scale(Vec3(2.0f, 3.0f, 4.0f));
+		static_assert(scale.get(0, 0) == 2.0f && scale.get(1, 1) == 3.0f && scale.get(2, 2) == 4.0f && scale.get(3, 3) == 1.0f, "Scale diagonal");
+
+		//Height 2, aspect 1 maps [-1, 1] to itself in x and y, and [near, far] to [-1, 1] in z
+		constexpr Mat4 ortho = Orthographic(2.0f, 1.0f, 1.0f, 3.0f);
+		static_assert(ortho.get(0, 0) == 1.0f && ortho.get(1, 1) == 1.0f, "Orthographic x and y scale");
+		static_assert(ortho.get(2, 2) == -1.0f && ortho.get(3, 2) == -2.0f && ortho.get(3, 3) == 1.0f, "Orthographic z");
+
+#if defined(EW_HAS_CONSTANT_EVALUATED)
+		//Products and trig only fold where the compiler can tell them to skip intrinsics and libm
+		constexpr Vec4 scaledPoint = Translate(Vec3(1.0f, 2.0f, 3.0f)) * Scale(Vec3(2.0f)) * Vec4(1.0f, 1.0f, 1.0f, 1.0f);
+		static_assert(scaledPoint.x == 3.0f && scaledPoint.y == 4.0f && scaledPoint.z == 5.0f && scaledPoint.w == 1.0f, "Translate * Scale * point");
+
+		//A quarter turn around Y sends +X to -Z
+		constexpr Mat4 rotateY = RotateY(1.5707963f);
+		constexpr Vec4 rotatedX = rotateY * Vec4(1.0f, 0.0f, 0.0f, 0.0f);
+		static_assert(Near(rotatedX.x, 0.0f) && Near(rotatedX.y, 0.0f) && Near(rotatedX.z, -1.0f), "RotateY quarter turn");
+		static_assert(Near(rotateY.get(1, 1), 1.0f) && Near(rotateY.get(3, 3), 1.0f), "RotateY keeps the axis");
+#endif
+	}
+}
@@ -0,0 +1,122 @@
+//Checks buildIndexBuffer's 16 bit chunking on meshes too big for a single 16 bit range, and its fallbacks to 32 bit.
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+#include <ew/procGen.h>
+#include <ew/indexBuffer.h>
+
+static int failures = 0;
+
+static void check(bool condition, const char* name, const char* what) {
+	if (!condition) {
+		printf("%s: %s\n", name, what);
+		failures++;
+	}
+}
+
+//Turns the packed buffer back into absolute indices, only covering what the chunks draw
+static std::vector<unsigned int> decode(const ew::IndexBufferLayout& layout, const std::vector<unsigned char>& data) {
+	std::vector<unsigned int> indices;
+	for (const ew::IndexChunk& chunk : layout.chunks)
+	{
+		for (size_t i = chunk.firstIndex; i < chunk.firstIndex + chunk.count; i++)
+		{
+			unsigned int index = 0;
+			if (layout.type == ew::IndexType::UINT16) {
+				uint16_t value;
+				memcpy(&value, data.data() + i * sizeof(value), sizeof(value));
+				index = value;
+			}
+			else {
+				memcpy(&index, data.data() + i * sizeof(index), sizeof(index));
+			}
+			indices.push_back(index + chunk.baseVertex);
+		}
+	}
+	return indices;
+}
+
+//Chunks must tile the indices in order, whole triangles each, and every absolute index has to fit 16 bits above baseVertex
+static void checkChunks(const char* name, const ew::IndexBufferLayout& layout, const unsigned int* indices, size_t usedCount) {
+	size_t next = 0;
+	for (const ew::IndexChunk& chunk : layout.chunks)
+	{
+		check(chunk.firstIndex == next, name, "chunks leave a gap");
+		check(chunk.count % 3 == 0, name, "chunk splits a triangle");
+		for (size_t i = chunk.firstIndex; i < chunk.firstIndex + chunk.count; i++)
+		{
+			if (indices[i] < (unsigned int)chunk.baseVertex || indices[i] - chunk.baseVertex > 0xFFFF) {
+				check(false, name, "chunk range doesn't fit 16 bits");
+				break;
+			}
+		}
+		next = chunk.firstIndex + chunk.count;
+	}
+	check(next == usedCount, name, "chunks don't cover every triangle");
+}
+
+int main() {
+	//More than 65536 vertices, split into chunks
+	{
+		const ew::MeshData plane = ew::createPlane(100.0f, 100.0f, 300);
+		std::vector<unsigned char> data;
+		const ew::IndexBufferLayout layout = ew::buildIndexBuffer(plane.indices.data(), plane.indices.size(), plane.vertices.size(), data);
+		printf("plane: %zu vertices, %zu chunks\n", plane.vertices.size(), layout.chunks.size());
+		check(plane.vertices.size() > 65536, "plane", "not big enough to need chunks");
+		check(layout.type == ew::IndexType::UINT16, "plane", "not 16 bit");
+		check(layout.chunks.size() > 1, "plane", "not split");
+		check(data.size() == plane.indices.size() * sizeof(uint16_t), "plane", "wrong buffer size");
+		checkChunks("plane", layout, plane.indices.data(), plane.indices.size());
+		check(decode(layout, data) == plane.indices, "plane", "decoded indices differ");
+	}
+
+	//Trailing indices short of a triangle are dropped
+	{
+		ew::MeshData plane = ew::createPlane(100.0f, 100.0f, 300);
+		const size_t triangleCount = plane.indices.size();
+		plane.indices.push_back(0);
+		plane.indices.push_back(1);
+		std::vector<unsigned char> data;
+		const ew::IndexBufferLayout layout = ew::buildIndexBuffer(plane.indices.data(), plane.indices.size(), plane.vertices.size(), data);
+		check(layout.type == ew::IndexType::UINT16, "trailing", "not 16 bit");
+		check(data.size() == triangleCount * sizeof(uint16_t), "trailing", "trailing indices kept");
+		checkChunks("trailing", layout, plane.indices.data(), triangleCount);
+		check(decode(layout, data) == std::vector<unsigned int>(plane.indices.begin(), plane.indices.begin() + triangleCount), "trailing", "decoded indices differ");
+	}
+
+	//One triangle spanning more than 65536 vertices can't be rebased into 16 bits
+	{
+		const std::vector<unsigned int> indices = { 0, 1, 2, 0, 2, 70000 };
+		std::vector<unsigned char> data;
+		const ew::IndexBufferLayout layout = ew::buildIndexBuffer(indices.data(), indices.size(), 70001, data);
+		check(layout.type == ew::IndexType::UINT32, "wide triangle", "not 32 bit");
+		check(layout.chunks.size() == 1 && layout.chunks[0].baseVertex == 0, "wide triangle", "not a single chunk");
+		check(decode(layout, data) == indices, "wide triangle", "decoded indices differ");
+	}
+
+	//Triangles jumping between far apart ranges need a chunk each, past MAX_INDEX_CHUNKS it is cheaper to stay 32 bit
+	{
+		std::vector<unsigned int> indices;
+		for (size_t i = 0; i <= ew::MAX_INDEX_CHUNKS; i++)
+		{
+			const unsigned int base = (i % 2) * 100000;
+			indices.insert(indices.end(), { base, base + 1, base + 2 });
+		}
+		std::vector<unsigned char> data;
+		const ew::IndexBufferLayout layout = ew::buildIndexBuffer(indices.data(), indices.size(), 100003, data);
+		check(layout.type == ew::IndexType::UINT32, "too many chunks", "not 32 bit");
+		check(decode(layout, data) == indices, "too many chunks", "decoded indices differ");
+
+		//One fewer triangle stays within the chunk limit
+		indices.resize(indices.size() - 3);
+		const ew::IndexBufferLayout fewer = ew::buildIndexBuffer(indices.data(), indices.size(), 100003, data);
+		check(fewer.type == ew::IndexType::UINT16 && fewer.chunks.size() == ew::MAX_INDEX_CHUNKS, "chunk limit", "not 16 bit in MAX_INDEX_CHUNKS chunks");
+		checkChunks("chunk limit", fewer, indices.data(), indices.size());
+		check(decode(fewer, data) == indices, "chunk limit", "decoded indices differ");
+	}
+
+	printf("indexBufferTest: %d failures\n", failures);
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,170 @@
+//Checks Mat4 * Mat4, Mat4 * Vec4 and the vecBatch array functions against a double precision reference.
+//Built twice by CMake, once with the SIMD backend and once with EW_SIMD_DISABLE, so both paths are covered.
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <vector>
+
+#include <ew/ewMath/mat4.h>
+#include <ew/ewMath/vecBatch.h>
+
+//Relative to the magnitude of the result, loose enough for FMA and reordered sums
+static const double EPSILON = 1e-5;
+
+static float randomFloat() {
+	return (float)rand() / RAND_MAX * 20.0f - 10.0f;
+}
+
+static ew::Mat4 randomMat4() {
+	ew::Mat4 m;
+	for (int c = 0; c < 4; c++)
+		m[c] = ew::Vec4(randomFloat(), randomFloat(), randomFloat(), randomFloat());
+	return m;
+}
+
+static bool near(double expected, float actual, double scale) {
+	return fabs(expected - actual) <= EPSILON * (1.0 + scale);
+}
+
+static std::vector<ew::Vec3> randomVec3s(size_t count) {
+	std::vector<ew::Vec3> v(count);
+	for (ew::Vec3& e : v)
+		e = ew::Vec3(randomFloat(), randomFloat(), randomFloat());
+	return v;
+}
+
+//Compares every component of a batch result against its double reference, reporting the first mismatch
+static int checkBatch(const char* name, size_t count, const std::vector<ew::Vec3>& actual, const std::vector<double>& expected, double scale) {
+	for (size_t i = 0; i < count * 3; i++)
+	{
+		const float a = (&actual[i / 3].x)[i % 3];
+		if (!near(expected[i], a, scale))
+		{
+			printf("%s count %zu [%zu]: expected %f, got %f\n", name, count, i, expected[i], a);
+			return 1;
+		}
+	}
+	return 0;
+}
+
+//Counts that aren't multiples of 4 vectors end with 1 to 3 leftover floats, covering the scalar tails
+static int checkVecBatch(size_t count) {
+	int failures = 0;
+	const std::vector<ew::Vec3> a = randomVec3s(count);
+	const std::vector<ew::Vec3> b = randomVec3s(count);
+	const float s = randomFloat();
+	std::vector<double> expected(count * 3);
+	auto component = [](const std::vector<ew::Vec3>& v, size_t i) { return (double)(&v[i / 3].x)[i % 3]; };
+
+	std::vector<ew::Vec3> out = a;
+	ew::AddN(out.data(), b.data(), count);
+	for (size_t i = 0; i < count * 3; i++)
+		expected[i] = component(a, i) + component(b, i);
+	failures += checkBatch("AddN", count, out, expected, 20.0);
+
+	out = a;
+	ew::ScaleN(out.data(), s, count);
+	for (size_t i = 0; i < count * 3; i++)
+		expected[i] = component(a, i) * s;
+	failures += checkBatch("ScaleN", count, out, expected, 100.0);
+
+	out = a;
+	ew::ScaleAddN(out.data(), b.data(), s, count);
+	for (size_t i = 0; i < count * 3; i++)
+		expected[i] = component(a, i) + component(b, i) * s;
+	failures += checkBatch("ScaleAddN", count, out, expected, 110.0);
+
+	out = a;
+	ew::NormalizeN(out.data(), count);
+	for (size_t v = 0; v < count; v++)
+	{
+		const double mag = sqrt((double)a[v].x * a[v].x + (double)a[v].y * a[v].y + (double)a[v].z * a[v].z);
+		for (int k = 0; k < 3; k++)
+			expected[v * 3 + k] = component(a, v * 3 + k) / mag;
+	}
+	failures += checkBatch("NormalizeN", count, out, expected, 1.0);
+
+	ew::CrossN(a.data(), b.data(), out.data(), count);
+	for (size_t v = 0; v < count; v++)
+	{
+		expected[v * 3 + 0] = (double)a[v].y * b[v].z - (double)a[v].z * b[v].y;
+		expected[v * 3 + 1] = (double)a[v].z * b[v].x - (double)a[v].x * b[v].z;
+		expected[v * 3 + 2] = (double)a[v].x * b[v].y - (double)a[v].y * b[v].x;
+	}
+	failures += checkBatch("CrossN", count, out, expected, 200.0);
+
+	const ew::Mat4 m = randomMat4();
+	out = a;
+	ew::TransformPointsN(m, out.data(), count);
+	for (size_t v = 0; v < count; v++)
+	{
+		for (int k = 0; k < 3; k++)
+			expected[v * 3 + k] = (double)m.get(0, k) * a[v].x + (double)m.get(1, k) * a[v].y + (double)m.get(2, k) * a[v].z + m.get(3, k);
+	}
+	failures += checkBatch("TransformPointsN", count, out, expected, 400.0);
+	return failures;
+}
+
+int main() {
+#if defined(EW_SIMD_SSE)
+	const char* backend = "SSE";
+#elif defined(EW_SIMD_NEON)
+	const char* backend = "NEON";
+#else
+	const char* backend = "scalar";
+#endif
+	srand(1);
+	int failures = 0;
+	for (int i = 0; i < 1000; i++)
+	{
+		const ew::Mat4 l = randomMat4();
+		const ew::Mat4 r = randomMat4();
+		const ew::Vec4 v(randomFloat(), randomFloat(), randomFloat(), randomFloat());
+
+		//Mat4 * Mat4, column c row k is dot(l_row_k, r_col_c)
+		const ew::Mat4 m = l * r;
+		for (int c = 0; c < 4; c++)
+		{
+			for (int k = 0; k < 4; k++)
+			{
+				double expected = 0.0, scale = 0.0;
+				for (int j = 0; j < 4; j++)
+				{
+					expected += (double)l.get(j, k) * r.get(c, j);
+					scale += fabs((double)l.get(j, k) * r.get(c, j));
+				}
+				if (!near(expected, m.get(c, k), scale))
+				{
+					printf("Mat4 * Mat4 [%d][%d]: expected %f, got %f\n", c, k, expected, m.get(c, k));
+					failures++;
+				}
+			}
+		}
+
+		//Mat4 * Vec4
+		const ew::Vec4 out = l * v;
+		const float outElements[4] = { out.x, out.y, out.z, out.w };
+		const float vElements[4] = { v.x, v.y, v.z, v.w };
+		for (int k = 0; k < 4; k++)
+		{
+			double expected = 0.0, scale = 0.0;
+			for (int j = 0; j < 4; j++)
+			{
+				expected += (double)l.get(j, k) * vElements[j];
+				scale += fabs((double)l.get(j, k) * vElements[j]);
+			}
+			if (!near(expected, outElements[k], scale))
+			{
+				printf("Mat4 * Vec4 [%d]: expected %f, got %f\n", k, expected, outElements[k]);
+				failures++;
+			}
+		}
+	}
+
+	const size_t batchCounts[] = { 1, 2, 3, 5, 7, 13, 103 };
+	for (size_t count : batchCounts)
+		failures += checkVecBatch(count);
+
+	printf("simdMathTest (%s): %d failures\n", backend, failures);
+	return failures == 0 ? 0 : 1;
+}
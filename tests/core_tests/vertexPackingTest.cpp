@@ -0,0 +1,55 @@
+//Round trips procedural meshes through PackedVertex and fails if any attribute loses more than its format allows.
+#include <stdio.h>
+#include <math.h>
+
+#include <ew/procGen.h>
+#include <ew/vertexPacking.h>
+
+//Normals are snorm10 per axis, half a step is about 0.11 degrees
+static const float MAX_NORMAL_ERROR_DEGREES = 0.2f;
+
+//Distance between adjacent half floats around x
+static float halfUlp(float x) {
+	const float magnitude = fmaxf(fabsf(x), 6.103515625e-05f); //Smallest normal half, subnormals are evenly spaced below it
+	return ldexpf(1.0f, (int)floorf(log2f(magnitude)) - 10);
+}
+
+static int checkMesh(const char* name, const ew::MeshData& mesh) {
+	const ew::PackingBounds bounds = ew::ComputePackingBounds(mesh.vertices.data(), mesh.vertices.size());
+	const ew::PackingError error = ew::MeasurePackingError(mesh.vertices.data(), mesh.vertices.size());
+
+	//Each axis is off by at most one snorm16 step of its extent, small slack for float rounding in the unpack
+	const float largestExtent = fmaxf(bounds.extents.x, fmaxf(bounds.extents.y, bounds.extents.z));
+	const float maxPositionError = largestExtent / 32767.0f * sqrtf(3.0f) * 1.001f;
+	float largestUV = 0.0f;
+	for (const ew::Vertex& v : mesh.vertices)
+		largestUV = fmaxf(largestUV, fmaxf(fabsf(v.uv.x), fabsf(v.uv.y)));
+	const float maxUVError = halfUlp(largestUV);
+
+	int failures = 0;
+	if (error.position > maxPositionError) {
+		printf("%s: position error %g above %g\n", name, error.position, maxPositionError);
+		failures++;
+	}
+	if (error.normalDegrees > MAX_NORMAL_ERROR_DEGREES) {
+		printf("%s: normal error %g degrees above %g\n", name, error.normalDegrees, MAX_NORMAL_ERROR_DEGREES);
+		failures++;
+	}
+	if (error.uv > maxUVError) {
+		printf("%s: uv error %g above %g\n", name, error.uv, maxUVError);
+		failures++;
+	}
+	printf("%s: position %g/%g normal %g/%g degrees uv %g/%g\n", name, error.position, maxPositionError,
+		error.normalDegrees, MAX_NORMAL_ERROR_DEGREES, error.uv, maxUVError);
+	return failures;
+}
+
+int main() {
+	int failures = 0;
+	failures += checkMesh("sphere", ew::createSphere(10.0f, 128));
+	failures += checkMesh("plane", ew::createPlane(100.0f, 100.0f, 128));
+	failures += checkMesh("cylinder", ew::createCylinder(1.0f, 20.0f, 128));
+	failures += checkMesh("cube", ew::createCube(0.5f));
+	printf("vertexPackingTest: %d failures\n", failures);
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,113 @@
+//Checks WeldVertices merges exactly what its tolerances allow: unindexed procedural meshes weld back to their original vertices,
+//matches are found across cell boundaries, -0 matches 0 in exact mode and attributes just outside tolerance stay apart.
+#include <stdio.h>
+#include <vector>
+
+#include <ew/procGen.h>
+#include <ew/vertexWeld.h>
+
+static int failures = 0;
+
+static void check(bool condition, const char* name, const char* what) {
+	if (!condition) {
+		printf("%s: %s\n", name, what);
+		failures++;
+	}
+}
+
+static bool sameVertex(const ew::Vertex& a, const ew::Vertex& b) {
+	return a.pos.x == b.pos.x && a.pos.y == b.pos.y && a.pos.z == b.pos.z
+		&& a.normal.x == b.normal.x && a.normal.y == b.normal.y && a.normal.z == b.normal.z
+		&& a.uv.x == b.uv.x && a.uv.y == b.uv.y;
+}
+
+//Expands every index into its own vertex, then welds and checks the original vertices and triangles come back.
+//Only vertices some triangle uses can come back, the sphere leaves a pole vertex per cap unreferenced
+static void checkUnindexed(const char* name, const ew::MeshData& mesh) {
+	ew::MeshData unindexed;
+	std::vector<bool> referenced(mesh.vertices.size(), false);
+	size_t referencedCount = 0;
+	for (size_t i = 0; i < mesh.indices.size(); i++)
+	{
+		unindexed.vertices.push_back(mesh.vertices[mesh.indices[i]]);
+		unindexed.indices.push_back((unsigned int)i);
+		if (!referenced[mesh.indices[i]]) {
+			referenced[mesh.indices[i]] = true;
+			referencedCount++;
+		}
+	}
+	const ew::WeldStats stats = ew::WeldVertices(unindexed);
+	printf("%s: %zu -> %zu vertices, %zu originally referenced\n", name, stats.verticesBefore, stats.verticesAfter, referencedCount);
+	check(stats.verticesBefore == mesh.indices.size(), name, "wrong vertex count before");
+	check(stats.verticesAfter == referencedCount, name, "didn't weld back to the original vertex count");
+	check(unindexed.vertices.size() == stats.verticesAfter, name, "vertices not resized");
+	for (size_t i = 0; i < mesh.indices.size(); i++)
+	{
+		if (unindexed.indices[i] >= unindexed.vertices.size() || !sameVertex(unindexed.vertices[unindexed.indices[i]], mesh.vertices[mesh.indices[i]])) {
+			check(false, name, "remapped indices give different triangles");
+			break;
+		}
+	}
+}
+
+static ew::Vertex makeVertex(float x, float y, float z) {
+	ew::Vertex v;
+	v.pos = ew::Vec3(x, y, z);
+	v.normal = ew::Vec3(0.0f, 1.0f, 0.0f);
+	v.uv = ew::Vec2(0.5f, 0.5f);
+	return v;
+}
+
+//Welds a and b as one triangle's worth of indices and returns the welded vertex count
+static size_t weldPair(const ew::Vertex& a, const ew::Vertex& b, const ew::WeldTolerances& tolerances) {
+	ew::MeshData mesh;
+	mesh.vertices = { a, b };
+	mesh.indices = { 0, 1, 1 };
+	return ew::WeldVertices(mesh, tolerances).verticesAfter;
+}
+
+int main() {
+	checkUnindexed("cube", ew::createCube(1.0f));
+	checkUnindexed("sphere", ew::createSphere(1.0f, 32));
+
+	const ew::WeldTolerances defaults;
+	const ew::Vertex base = makeVertex(1.0f, 2.0f, 3.0f);
+
+	//Positions within tolerance but on either side of a cell edge, cells are one tolerance wide
+	{
+		ew::WeldTolerances tolerances;
+		tolerances.position = 0.01f;
+		check(weldPair(makeVertex(0.0299f, 0.0f, 0.0f), makeVertex(0.0301f, 0.0f, 0.0f), tolerances) == 1, "cell boundary", "not merged");
+		check(weldPair(makeVertex(0.0f, -0.0001f, 0.0f), makeVertex(0.0f, 0.0001f, 0.0f), tolerances) == 1, "cell boundary at 0", "not merged");
+		check(weldPair(makeVertex(0.0299f, 0.0f, 0.0f), makeVertex(0.0401f, 0.0f, 0.0f), tolerances) == 2, "next cell out of tolerance", "merged");
+	}
+
+	//Exact mode only merges identical positions, with -0 the same as 0
+	{
+		ew::WeldTolerances exact;
+		exact.position = 0.0f;
+		exact.normal = 0.0f;
+		exact.uv = 0.0f;
+		check(weldPair(makeVertex(0.0f, 2.0f, 0.0f), makeVertex(-0.0f, 2.0f, -0.0f), exact) == 1, "exact -0", "-0 not merged with 0");
+		check(weldPair(base, base, exact) == 1, "exact", "identical vertices not merged");
+		check(weldPair(base, makeVertex(1.0f, 2.0f, 3.0000002f), exact) == 2, "exact", "merged one ulp apart");
+	}
+
+	//Normals and uvs merge inside tolerance and stay apart just outside it
+	{
+		ew::Vertex normal = base;
+		normal.normal.x += defaults.normal * 0.5f;
+		check(weldPair(base, normal, defaults) == 1, "normal inside tolerance", "not merged");
+		normal.normal.x = base.normal.x + defaults.normal * 1.5f;
+		check(weldPair(base, normal, defaults) == 2, "normal outside tolerance", "merged");
+
+		ew::Vertex uv = base;
+		uv.uv.y += defaults.uv * 0.5f;
+		check(weldPair(base, uv, defaults) == 1, "uv inside tolerance", "not merged");
+		uv.uv.y = base.uv.y + defaults.uv * 1.5f;
+		check(weldPair(base, uv, defaults) == 2, "uv outside tolerance", "merged");
+	}
+
+	printf("vertexWeldTest: %d failures\n", failures);
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,53 @@
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+
+#include <patchwork/modelImport.h>
+#include <patchwork/cookedModel.h>
+
+static void printUsage()
+{
+	printf("Usage: ewcook <input model> <output%s> [--no-weld] [--no-meshlets]\n", patchwork::COOKED_MODEL_EXTENSION);
+	printf("Imports any format Assimp reads, welds, optimizes and builds meshlets and LODs, then writes a file patchwork::Model can map.\n");
+}
+
+int main(int argc, char** argv) {
+	if (argc < 3) {
+		printUsage();
+		return 1;
+	}
+	const char* input = argv[1];
+	const char* output = argv[2];
+	patchwork::ModelImportSettings settings;
+	for (int i = 3; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--no-weld") == 0)
+			settings.weld = false;
+		else if (strcmp(argv[i], "--no-meshlets") == 0)
+			settings.buildMeshlets = false;
+		else {
+			printf("Unknown option %s\n", argv[i]);
+			printUsage();
+			return 1;
+		}
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+	patchwork::ImportedModel model;
+	if (!patchwork::ImportModel(input, settings, model))
+		return 1;
+	if (!patchwork::WriteCookedModel(output, model))
+		return 1;
+	const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	size_t vertices = 0, indices = 0, meshlets = 0;
+	for (const patchwork::ImportedMesh& mesh : model.meshes)
+	{
+		vertices += mesh.vertices.size();
+		indices += mesh.indices.size();
+		meshlets += mesh.meshlets.size();
+	}
+	printf("%s -> %s: %zu meshes, %zu vertices (%.2fx welded), %zu indices, %zu meshlets in %.1fms\n", input, output,
+		model.meshes.size(), vertices, model.weldStats.reduction(), indices, meshlets, ms);
+	return 0;
+}